@@ -0,0 +1,849 @@
+#include "../imgui-knobs-smoother.h"
+#include "../imgui-knobs.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "rasterizer.h"
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Options {
+    int knobs = 2000;
+    int frames = 100;
+    int warmup = 10;
+    float size = 32.0f;
+    bool mesh_cache = true;
+    float lod_max_error = 0.0f;
+    ImGuiKnobFlags flags = 0;
+    bool check_allocations = false;
+    bool bank = false;
+    bool grid = false;
+    bool handles = false;
+    bool skin = false;
+    bool baked = false;
+    bool filmstrip = false;
+    bool overdraw = false;
+    const char *heatmaps = NULL;// Path prefix of the overdraw heatmaps
+    bool smoother = false;
+    bool check_format = false;
+    bool check_ids = false;
+    unsigned int format_stride = 4099;
+};
+
+// Labels, values and ranges are prepared up front so that only the knobs themselves are timed
+struct KnobData {
+    const char **labels;
+    float *values;
+    float *mins;
+    float *maxes;
+    int *int_values;
+    int *int_mins;
+    int *int_maxes;
+    ImGuiKnobs::KnobHandle *handles;// Made from the labels on the first frame, in the benchmark window
+};
+
+struct Variant {
+    ImGuiKnobVariant variant;
+    const char *name;
+    const char *skin;// Skin drawing the same knob (Space only approximately)
+};
+
+#define VARIANT(V, SKIN) {ImGuiKnobVariant_##V, #V, SKIN}
+
+static const Variant variants[] = {
+        VARIANT(Tick, "circle 0.85; tick 0.5 0.85 0.08"),
+        VARIANT(Dot, "circle 0.85; dot 0.6 0.12"),
+        VARIANT(Wiper, "circle 0.7; track 0.8 0.41; value 0.8 0.43; modulation 0.8 0.12"),
+        VARIANT(WiperOnly, "track 0.8 0.41; value 0.8 0.43; modulation 0.8 0.12"),
+        VARIANT(WiperDot, "circle 0.6; track 0.85 0.41; modulation 0.85 0.12; dot 0.85 0.1"),
+        VARIANT(Stepped, "ticks 0.7 0.9 0.04; circle 0.6; dot 0.4 0.12"),
+        VARIANT(Space, "circle 0.25; value 0.4 0.15; value 0.6 0.15; value 0.8 0.15"),
+};
+
+#undef VARIANT
+
+static const int variant_count = IM_ARRAYSIZE(variants);
+static ImGuiKnobs::Skin skins[variant_count];// Parsed from Variant::skin
+
+// Heap allocations made through ImGui's allocator and the global operator new are counted while
+// `counting_allocations` is set, so that the steady state of every knob can be checked to be allocation free
+static bool counting_allocations = false;
+static int allocation_count = 0;
+
+static void *counting_malloc(size_t size, void *) {
+    if (counting_allocations) {
+        allocation_count++;
+    }
+    return malloc(size);
+}
+
+static void counting_free(void *ptr, void *) {
+    free(ptr);
+}
+
+void *operator new(size_t size) {
+    if (counting_allocations) {
+        allocation_count++;
+    }
+    if (void *ptr = malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+static const char *primitive_names[ImGuiKnobs::StatsPrimitive_COUNT] = {"circle", "arc", "tick", "dot"};
+
+static void print_stats(ImGuiKnobVariant variant) {
+    const auto &stats = ImGuiKnobs::GetStats();
+    auto index = ImGuiKnobs::Stats::VariantIndex(variant);
+    auto knobs = stats.knobs[index];
+    if (knobs == 0) {
+        return;
+    }
+
+    for (int p = 0; p < ImGuiKnobs::StatsPrimitive_COUNT; p++) {
+        const auto &c = stats.counters[index][p];
+        if (c.calls == 0) {
+            continue;
+        }
+        printf("    %-8s calls/knob %6.2f  vtx/knob %7.1f  idx/knob %7.1f  points/knob %7.1f\n",
+               primitive_names[p],
+               (double) c.calls / knobs,
+               (double) c.vertices / knobs,
+               (double) c.indices / knobs,
+               (double) c.path_points / knobs);
+    }
+}
+#endif
+
+struct FrameResult {
+    double ns;
+    int vtx;
+    int idx;
+    int cmds;
+    ImVec2 first_min;
+    ImVec2 first_max;
+    int idx_start;// Index of the first knob triangle in the window draw list, after the window background
+};
+
+static int compare_double(const void *a, const void *b) {
+    auto x = *(const double *) a;
+    auto y = *(const double *) b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static Options parse_options(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; i += 2) {
+        if (strcmp(argv[i], "--no-mesh-cache") == 0) {
+            options.mesh_cache = false;
+            i--;
+        } else if (strcmp(argv[i], "--check-allocations") == 0) {
+            options.check_allocations = true;
+            i--;
+        } else if (strcmp(argv[i], "--check-ids") == 0) {
+            options.check_ids = true;
+            i--;
+        } else if (strcmp(argv[i], "--check-format") == 0) {
+            options.check_format = true;
+            i--;
+        } else if (strcmp(argv[i], "--format-stride") == 0 && i + 1 < argc) {
+            options.format_stride = (unsigned int) strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--smoother") == 0) {
+            options.smoother = true;
+            i--;
+        } else if (strcmp(argv[i], "--grid") == 0) {
+            options.grid = true;
+            i--;
+        } else if (strcmp(argv[i], "--skin") == 0) {
+            options.skin = true;
+            i--;
+        } else if (strcmp(argv[i], "--overdraw") == 0) {
+            options.overdraw = true;
+            i--;
+        } else if (strcmp(argv[i], "--filmstrip") == 0) {
+            options.filmstrip = true;
+            i--;
+        } else if (strcmp(argv[i], "--baked") == 0) {
+            options.baked = true;
+            i--;
+        } else if (strcmp(argv[i], "--handles") == 0) {
+            options.handles = true;
+            i--;
+        } else if (strcmp(argv[i], "--bank") == 0) {
+            options.bank = true;
+            i--;
+        } else if (strcmp(argv[i], "--draw-only") == 0) {
+            // Leave out the title and input to isolate the cost of the knob geometry
+            options.flags |= ImGuiKnobFlags_NoTitle | ImGuiKnobFlags_NoInput;
+            i--;
+        } else if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+            exit(1);
+        } else if (strcmp(argv[i], "--knobs") == 0) {
+            options.knobs = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--frames") == 0) {
+            options.frames = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--size") == 0) {
+            options.size = (float) atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--heatmaps") == 0) {
+            options.heatmaps = argv[i + 1];
+        } else if (strcmp(argv[i], "--lod-max-error") == 0) {
+            options.lod_max_error = (float) atof(argv[i + 1]);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            exit(1);
+        }
+    }
+    return options;
+}
+
+static void setup(const Options &options) {
+    IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(counting_malloc, counting_free);
+    ImGui::CreateContext();
+    ImGuiIO &io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.LogFilename = NULL;
+    io.DisplaySize = ImVec2(4096.0f, 4096.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+
+    for (int i = 0; i < variant_count; i++) {
+        skins[i].Parse(variants[i].skin);
+    }
+
+    // The variants and their skins at the benchmark size, before the atlas is built
+    if (options.baked) {
+        for (int i = 0; i < variant_count; i++) {
+            ImGuiKnobs::BakeKnobBackground(io.Fonts, variants[i].variant, options.size);
+            ImGuiKnobs::BakeKnobBackground(io.Fonts, skins[i], options.size);
+        }
+    }
+
+    // No renderer: building the atlas is enough for NewFrame()
+    unsigned char *pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    if (options.baked) {
+        ImGuiKnobs::RenderKnobBackgrounds(io.Fonts);
+    }
+
+    ImGui::StyleColorsDark();
+}
+
+static FrameResult run_frame(const Options &options, const KnobData &data, const Variant &v, bool use_int) {
+    auto variant = v.variant;
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Benchmark", NULL, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+
+    auto *draw_list = ImGui::GetWindowDrawList();
+    const int vtx_start = draw_list->VtxBuffer.Size;
+    const int idx_start = draw_list->IdxBuffer.Size;
+    const int cmd_start = draw_list->CmdBuffer.Size;
+    const float cell_width = options.size + ImGui::GetStyle().ItemSpacing.x;
+    int columns = (int) (ImGui::GetContentRegionAvail().x / cell_width);
+    if (columns < 1) {
+        columns = 1;
+    }
+
+    FrameResult result;
+    auto first_pos = ImGui::GetCursorScreenPos();
+    auto start = std::chrono::steady_clock::now();
+    if (options.grid && use_int) {
+        ImGuiKnobs::KnobGridInt("grid", data.int_values, data.int_mins, data.int_maxes, data.labels, options.knobs, columns, 0, "%i", variant, options.size, options.flags);
+    } else if (options.grid) {
+        ImGuiKnobs::KnobGrid("grid", data.values, data.mins, data.maxes, data.labels, options.knobs, columns, 0, "%.1fdB", variant, options.size, options.flags);
+    } else if (options.bank && use_int) {
+        ImGuiKnobs::KnobBankInt("bank", data.int_values, data.int_mins, data.int_maxes, data.labels, options.knobs, columns, 0, "%i", variant, options.size, options.flags);
+    } else if (options.bank) {
+        ImGuiKnobs::KnobBank("bank", data.values, data.mins, data.maxes, data.labels, options.knobs, columns, 0, "%.1fdB", variant, options.size, options.flags);
+    } else if (options.skin) {
+        const auto &skin = skins[&v - variants];
+        for (int i = 0; i < options.knobs; i++) {
+            if (i % columns != 0) {
+                ImGui::SameLine();
+            }
+            if (use_int) {
+                ImGuiKnobs::KnobInt(data.labels[i], &data.int_values[i], data.int_mins[i], data.int_maxes[i], skin, 0, "%i", options.size, options.flags);
+            } else {
+                ImGuiKnobs::Knob(data.labels[i], &data.values[i], data.mins[i], data.maxes[i], skin, 0, "%.1fdB", options.size, options.flags);
+            }
+        }
+    } else if (options.filmstrip) {
+        // 64 frames in 8 columns of the font atlas, so the quads batch with the text
+        const ImGuiKnobs::Filmstrip filmstrip(ImGui::GetIO().Fonts->TexID, 64, 8);
+        for (int i = 0; i < options.knobs; i++) {
+            if (i % columns != 0) {
+                ImGui::SameLine();
+            }
+            if (use_int) {
+                ImGuiKnobs::KnobFilmstripInt(data.labels[i], &data.int_values[i], data.int_mins[i], data.int_maxes[i], filmstrip, 0, "%i", options.size, options.flags);
+            } else {
+                ImGuiKnobs::KnobFilmstrip(data.labels[i], &data.values[i], data.mins[i], data.maxes[i], filmstrip, 0, "%.1fdB", options.size, options.flags);
+            }
+        }
+    } else if (options.handles) {
+        if (data.handles[0].scope_id == 0) {
+            for (int i = 0; i < options.knobs; i++) {
+                data.handles[i] = ImGuiKnobs::KnobHandle(data.labels[i]);
+            }
+        }
+        for (int i = 0; i < options.knobs; i++) {
+            if (i % columns != 0) {
+                ImGui::SameLine();
+            }
+            if (use_int) {
+                ImGuiKnobs::KnobInt(data.handles[i], data.labels[i], &data.int_values[i], data.int_mins[i], data.int_maxes[i], 0, "%i", variant, options.size, options.flags);
+            } else {
+                ImGuiKnobs::Knob(data.handles[i], data.labels[i], &data.values[i], data.mins[i], data.maxes[i], 0, "%.1fdB", variant, options.size, options.flags);
+            }
+        }
+    } else {
+        for (int i = 0; i < options.knobs; i++) {
+            if (i % columns != 0) {
+                ImGui::SameLine();
+            }
+            if (use_int) {
+                ImGuiKnobs::KnobInt(data.labels[i], &data.int_values[i], data.int_mins[i], data.int_maxes[i], 0, "%i", variant, options.size, options.flags);
+            } else {
+                ImGuiKnobs::Knob(data.labels[i], &data.values[i], data.mins[i], data.maxes[i], 0, "%.1fdB", variant, options.size, options.flags);
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // All knobs have the same size, so the last item gives the extent of the first one
+    result.first_min = first_pos;
+    result.first_max = ImVec2(first_pos.x + ImGui::GetItemRectSize().x, first_pos.y + ImGui::GetItemRectSize().y);
+    result.ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    result.vtx = draw_list->VtxBuffer.Size - vtx_start;
+    result.idx = draw_list->IdxBuffer.Size - idx_start;
+    result.cmds = draw_list->CmdBuffer.Size - cmd_start + 1;
+    result.idx_start = idx_start;
+
+    ImGui::End();
+    ImGui::Render();
+
+    return result;
+}
+
+// Mouse input replayed on the first knob: hover, then drag the knob itself, then drag its value input.
+// Every frame of the cycle is seen during warm-up, so tooltips, active ids and input states already exist.
+static const int mouse_cycle = 16;
+
+static void queue_mouse_input(const Options &options, const FrameResult &previous, int frame) {
+    auto &io = ImGui::GetIO();
+    auto step = frame % mouse_cycle;
+    auto x = (previous.first_min.x + previous.first_max.x) * 0.5f;
+    auto knob_y = previous.first_min.y + options.size * 0.5f;
+    if (!(options.flags & ImGuiKnobFlags_NoTitle)) {
+        knob_y += ImGui::GetTextLineHeightWithSpacing();
+    }
+    auto input_y = previous.first_max.y - ImGui::GetFrameHeight() * 0.5f;
+    auto y = step < mouse_cycle / 2 ? knob_y : input_y;
+    auto phase = step % (mouse_cycle / 2);
+
+    io.AddMousePosEvent(x + (phase >= 2 && phase < 6 ? (float) phase * 4.0f : 0.0f), y - (phase >= 2 && phase < 6 ? (float) phase * 4.0f : 0.0f));
+    io.AddMouseButtonEvent(0, phase >= 1 && phase < 6);
+}
+
+// Presses a knob drawn next to a button of the same label and checks that only the knob becomes active, with
+// the ID a knob always had: its label inside the ID scope of its label (or of its index in a bank)
+static int check_ids() {
+    enum { case_label, case_handle, case_id_handle, case_bank, case_count };
+    static const char *const case_names[case_count] = {"label", "handle", "id handle", "bank"};
+    const char *const labels[] = {"Gain"};
+    const float mins[] = {0.0f};
+    const float maxes[] = {1.0f};
+    const ImGuiKnobFlags flags = ImGuiKnobFlags_NoTitle | ImGuiKnobFlags_NoInput;
+    auto &io = ImGui::GetIO();
+    int failures = 0;
+
+    for (int c = 0; c < case_count; c++) {
+        float value = 0.5f;
+        ImVec2 knob_center(0.0f, 0.0f);
+        ImGuiID expected = 0;
+        ImGuiID button_id = 0;
+        ImGuiID active_id = 0;
+        bool button_active = false;
+
+        // Lay out, hover the knob, press it, hold it, release it
+        for (int frame = 0; frame < 5; frame++) {
+            if (frame == 1) {
+                io.AddMousePosEvent(knob_center.x, knob_center.y);
+            }
+            if (frame == 2 || frame == 4) {
+                io.AddMouseButtonEvent(0, frame == 2);
+            }
+
+            char window[32];
+            snprintf(window, sizeof(window), "IDs %d", c);
+            ImGui::NewFrame();
+            ImGui::SetNextWindowPos(ImVec2(0, 0));
+            ImGui::SetNextWindowSize(ImVec2(400, 400));
+            ImGui::Begin(window, NULL, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+
+            ImGui::Button("Gain");
+            button_id = ImGui::GetItemID();
+            button_active = ImGui::IsItemActive();
+            ImGui::SameLine();
+            auto pos = ImGui::GetCursorScreenPos();
+            knob_center = ImVec2(pos.x + 32.0f, pos.y + 32.0f);
+
+            switch (c) {
+                case case_label:
+                    ImGuiKnobs::Knob("Gain", &value, 0.0f, 1.0f, 0, "%.3f", ImGuiKnobVariant_Tick, 64.0f, flags);
+                    break;
+                case case_handle:
+                    ImGuiKnobs::Knob(ImGuiKnobs::KnobHandle("Gain"), "Gain", &value, 0.0f, 1.0f, 0, "%.3f", ImGuiKnobVariant_Tick, 64.0f, flags);
+                    break;
+                case case_id_handle: {
+                    ImGuiKnobs::KnobHandle handle(ImGui::GetID("Gain"));
+                    ImGuiKnobs::Knob(handle, "Gain", &value, 0.0f, 1.0f, 0, "%.3f", ImGuiKnobVariant_Tick, 64.0f, flags);
+                    expected = handle.button_id;
+                    break;
+                }
+                case case_bank:
+                    ImGuiKnobs::KnobBank("bank", &value, mins, maxes, labels, 1, 1, 0, "%.3f", ImGuiKnobVariant_Tick, 64.0f, flags);
+                    ImGui::PushID("bank");
+                    ImGui::PushID(0);
+                    expected = ImGui::GetID("Gain");
+                    ImGui::PopID();
+                    ImGui::PopID();
+                    break;
+            }
+            if (c == case_label || c == case_handle) {
+                ImGui::PushID("Gain");
+                expected = ImGui::GetID("Gain");
+                ImGui::PopID();
+            }
+            if (frame == 3) {
+                active_id = ImGui::GetActiveID();
+            }
+
+            ImGui::End();
+            ImGui::Render();
+        }
+
+        auto ok = active_id == expected && active_id != button_id && !button_active;
+        printf("%-10s knob 0x%08x, expected 0x%08x, button 0x%08x%s: %s\n",
+               case_names[c],
+               active_id,
+               expected,
+               button_id,
+               button_active ? " (active)" : "",
+               ok ? "ok" : "FAILED");
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+// Runs every variant with every flag combination and reports any heap allocation after warm-up
+static int check_allocations(Options options, const KnobData &data) {
+    const ImGuiKnobFlags all_flags = ImGuiKnobFlags_NoTitle | ImGuiKnobFlags_NoInput | ImGuiKnobFlags_ValueTooltip |
+                                     ImGuiKnobFlags_DragHorizontal | ImGuiKnobFlags_DragVertical |
+                                     ImGuiKnobFlags_Logarithmic | ImGuiKnobFlags_AlwaysClamp;
+    const int warmup = mouse_cycle * 2;
+    int failures = 0;
+    int runs = 0;
+
+    printf("%d knobs per frame, %d frames after %d warm-up frames, size %.0f px, mesh cache %s%s%s\n\n",
+           options.knobs,
+           options.frames,
+           warmup,
+           options.size,
+           options.mesh_cache ? "on" : "off",
+           options.baked ? ", baked" : "",
+           options.grid ? ", grid" : (options.bank ? ", bank" : (options.handles ? ", handles" : (options.skin ? ", skin" : (options.filmstrip ? ", filmstrip" : "")))));
+
+    for (const auto &v: variants) {
+        for (int use_int = 0; use_int < 2; use_int++) {
+            for (ImGuiKnobFlags flags = 0; flags <= all_flags; flags++) {
+                options.flags = flags;
+                FrameResult previous = {0, 0, 0, 0, ImVec2(0, 0), ImVec2(0, 0), 0};
+                allocation_count = 0;
+                for (int frame = 0; frame < warmup + options.frames; frame++) {
+                    queue_mouse_input(options, previous, frame);
+                    counting_allocations = frame >= warmup;
+                    previous = run_frame(options, data, v, use_int != 0);
+                }
+                counting_allocations = false;
+                runs++;
+
+                if (allocation_count > 0) {
+                    printf("%-10s %-6s flags 0x%02x: %d allocations in %d frames\n",
+                           v.name,
+                           use_int ? "int" : "float",
+                           flags,
+                           allocation_count,
+                           options.frames);
+                    failures++;
+                }
+            }
+        }
+    }
+
+    printf("%d of %d runs allocated after warm-up\n", failures, runs);
+    return failures == 0 ? 0 : 1;
+}
+
+static int run_benchmark(const Options &options, const KnobData &data, double *frame_ns) {
+    printf("%d knobs per frame, %d frames, size %.0f px, mesh cache %s%s%s%s\n\n",
+           options.knobs,
+           options.frames,
+           options.size,
+           options.mesh_cache ? "on" : "off",
+           options.baked ? ", baked" : "",
+           options.flags ? ", draw only" : "",
+           options.grid ? ", grid" : (options.bank ? ", bank" : (options.handles ? ", handles" : (options.skin ? ", skin" : (options.filmstrip ? ", filmstrip" : "")))));
+    printf("%-10s %-6s %10s %10s %10s %10s\n", "variant", "type", "ns/knob", "vtx/knob", "idx/knob", "draw cmds");
+
+    for (const auto &v: variants) {
+        for (int use_int = 0; use_int < 2; use_int++) {
+            FrameResult total = {0, 0, 0, 0, ImVec2(0, 0), ImVec2(0, 0), 0};
+            for (int frame = 0; frame < options.warmup + options.frames; frame++) {
+                FrameResult result = run_frame(options, data, v, use_int != 0);
+                if (frame < options.warmup) {
+                    continue;
+                }
+                frame_ns[frame - options.warmup] = result.ns;
+                total.vtx = result.vtx;
+                total.idx = result.idx;
+                total.cmds = result.cmds;
+            }
+
+            // The median is far less sensitive to scheduler noise than the mean
+            qsort(frame_ns, options.frames, sizeof(*frame_ns), compare_double);
+            total.ns = frame_ns[options.frames / 2];
+
+            printf("%-10s %-6s %10.1f %10.1f %10.1f %10d\n",
+                   v.name,
+                   use_int ? "int" : "float",
+                   total.ns / options.knobs,
+                   (double) total.vtx / options.knobs,
+                   (double) total.idx / options.knobs,
+                   total.cmds);
+#ifdef IMGUIKNOBS_ENABLE_STATS
+            print_stats(v.variant);
+#endif
+        }
+    }
+
+    return 0;
+}
+
+// Rasterizes a frame of knobs for each variant and size, and reports the pixels they fill: fragments (the fill
+// cost) and covered pixels per knob, the average overdraw of the covered pixels and the deepest pixel
+static int run_overdraw(Options options, const KnobData &data) {
+    static const float sizes[] = {16.0f, 24.0f, 32.0f, 48.0f, 64.0f, 96.0f, 128.0f};
+
+    // One knob per value of the data, which fits the display at every size
+    options.knobs = options.knobs < 97 ? options.knobs : 97;
+
+    const auto &io = ImGui::GetIO();
+    OverdrawRasterizer rasterizer((int) io.DisplaySize.x, (int) io.DisplaySize.y);
+    printf("%d knobs per frame, mesh cache %s%s%s%s\n\n",
+           options.knobs,
+           options.mesh_cache ? "on" : "off",
+           options.baked ? ", baked" : "",
+           options.flags ? ", draw only" : "",
+           options.grid ? ", grid" : (options.bank ? ", bank" : (options.handles ? ", handles" : (options.skin ? ", skin" : (options.filmstrip ? ", filmstrip" : "")))));
+    printf("%-10s %6s %12s %12s %10s %10s\n", "variant", "size", "frags/knob", "pixels/knob", "overdraw", "max depth");
+
+    for (const auto &v: variants) {
+        for (float size: sizes) {
+            options.size = size;
+
+            // The first frame only lays out the window
+            FrameResult result = run_frame(options, data, v, false);
+            result = run_frame(options, data, v, false);
+
+            rasterizer.clear();
+            const auto *draw_data = ImGui::GetDrawData();
+            for (int n = 0; n < draw_data->CmdListsCount; n++) {
+                const auto *draw_list = draw_data->CmdLists[n];
+                rasterizer.draw(draw_list, strcmp(draw_list->_OwnerName, "Benchmark") == 0 ? result.idx_start : 0);
+            }
+
+            auto stats = rasterizer.stats();
+            printf("%-10s %6.0f %12.1f %12.1f %10.2f %10d\n",
+                   v.name,
+                   size,
+                   (double) stats.fragments / options.knobs,
+                   (double) stats.covered / options.knobs,
+                   stats.covered ? (double) stats.fragments / stats.covered : 0.0,
+                   stats.max_depth);
+
+            if (options.heatmaps) {
+                char path[512];
+                snprintf(path, sizeof(path), "%s%s-%.0f.pgm", options.heatmaps, v.name, size);
+                if (!rasterizer.write_heatmap(path)) {
+                    fprintf(stderr, "Could not write %s\n", path);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Times KnobSmoother for `knobs` parameters with new targets on every block, once advancing whole blocks
+// and once writing every sample of every parameter
+static int run_smoother(const Options &options) {
+    const int block = 256;
+    const float sample_rate = 48000.0f;
+    float *samples = (float *) malloc(sizeof(*samples) * block * options.knobs);
+    float **outputs = (float **) malloc(sizeof(*outputs) * options.knobs);
+    for (int i = 0; i < options.knobs; i++) {
+        outputs[i] = &samples[i * block];
+    }
+    double *block_ns = (double *) malloc(sizeof(*block_ns) * options.frames);
+
+    printf("%d parameters, %d blocks of %d samples\n\n", options.knobs, options.frames, block);
+    printf("%-10s %-8s %14s %14s\n", "mode", "output", "ns/block", "ns/param");
+
+    const ImGuiKnobSmootherMode modes[] = {ImGuiKnobSmootherMode_OnePole, ImGuiKnobSmootherMode_Linear};
+    const char *mode_names[] = {"one-pole", "linear"};
+    for (int m = 0; m < 2; m++) {
+        for (int per_sample = 0; per_sample < 2; per_sample++) {
+            ImGuiKnobs::KnobSmoother smoother(options.knobs, modes[m], 0.02f, sample_rate);
+            for (int frame = 0; frame < options.warmup + options.frames; frame++) {
+                for (int i = frame % 16; i < options.knobs; i += 16) {
+                    smoother.SetTarget(i, (float) ((i + frame) % 97));
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                smoother.Process(block, per_sample ? outputs : NULL);
+                auto end = std::chrono::steady_clock::now();
+                if (frame >= options.warmup) {
+                    block_ns[frame - options.warmup] = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                }
+            }
+
+            qsort(block_ns, options.frames, sizeof(*block_ns), compare_double);
+            auto ns = block_ns[options.frames / 2];
+            printf("%-10s %-8s %14.1f %14.2f\n", mode_names[m], per_sample ? "samples" : "block", ns, ns / options.knobs);
+        }
+    }
+
+    free(samples);
+    free(outputs);
+    free(block_ns);
+    return 0;
+}
+
+static const char *float_formats[] = {"%.0f", "%.1f", "%.2f", "%.3f", "%.7f", "%f", "%.1fdB", "Gain: %.2f dB", "%5.2f", "%e"};
+static const char *int_formats[] = {"%i", "%d", "%d Hz", "%03d"};
+
+// Compares one value against vsnprintf, which is what ImGui::DataTypeFormatString() uses
+static bool check_float(const char *format, float v) {
+    char expected[64], actual[64];
+    auto expected_length = snprintf(expected, sizeof(expected), format, (double) v);
+    auto actual_length = ImGuiKnobs::FormatValue(actual, sizeof(actual), ImGuiDataType_Float, &v, format);
+    if (expected_length != actual_length || strcmp(expected, actual) != 0) {
+        printf("mismatch: format \"%s\" value %.9g: expected \"%s\", got \"%s\"\n", format, (double) v, expected, actual);
+        return false;
+    }
+    return true;
+}
+
+static bool check_int(const char *format, int v) {
+    char expected[64], actual[64];
+    auto expected_length = snprintf(expected, sizeof(expected), format, v);
+    auto actual_length = ImGuiKnobs::FormatValue(actual, sizeof(actual), ImGuiDataType_S32, &v, format);
+    if (expected_length != actual_length || strcmp(expected, actual) != 0) {
+        printf("mismatch: format \"%s\" value %d: expected \"%s\", got \"%s\"\n", format, v, expected, actual);
+        return false;
+    }
+    return true;
+}
+
+// Checks ImGuiKnobs::FormatValue() against vsnprintf over every `stride`-th float bit pattern (1 is exhaustive),
+// rounding ties and edge cases, then times both
+static int check_format(const Options &options) {
+    int mismatches = 0;
+    long long checked = 0;
+    const unsigned int stride = options.format_stride ? options.format_stride : 1;
+
+    for (const char *format: float_formats) {
+        // Values exactly halfway between two outputs must round to even like printf
+        for (int precision = 0; precision <= 7; precision++) {
+            for (int k = -2000; k <= 2000; k++) {
+                auto v = (float) ((k + 0.5) / pow(10.0, precision));
+                mismatches += !check_float(format, v);
+                checked++;
+            }
+        }
+
+        const float edges[] = {0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 0.125f, 0.375f, 1e15f, 9e15f, -9e15f, 1e16f, FLT_MAX, -FLT_MAX, FLT_MIN, 1e-45f, -1e-45f, INFINITY, -INFINITY, NAN};
+        for (float v: edges) {
+            mismatches += !check_float(format, v);
+            checked++;
+        }
+
+        for (unsigned long long bits = 0; bits <= 0xffffffffull; bits += stride) {
+            auto b = (unsigned int) bits;
+            float v;
+            memcpy(&v, &b, sizeof(v));
+            mismatches += !check_float(format, v);
+            checked++;
+            if (mismatches > 20) {
+                printf("too many mismatches\n");
+                return 1;
+            }
+        }
+    }
+
+    for (const char *format: int_formats) {
+        const int edges[] = {0, -1, 1, 2147483647, -2147483647 - 1};
+        for (int v: edges) {
+            mismatches += !check_int(format, v);
+            checked++;
+        }
+        for (long long v = -2147483648ll; v <= 2147483647ll; v += stride) {
+            mismatches += !check_int(format, (int) v);
+            checked++;
+        }
+    }
+
+    // A format rewritten in place, like a label buffer rebuilt each frame, must not reuse the previous format
+    char reused[32];
+    const char *float_rewrites[] = {"%.1f", "%.3fdB", "%5.2f", "%.2f", "%e", "%.0f%%", "%.1f"};
+    const float float_values[] = {0.0f, 1.23456f, -7.5f, 1234.5678f};
+    for (const char *format: float_rewrites) {
+        strcpy(reused, format);
+        for (float v: float_values) {
+            mismatches += !check_float(reused, v);
+            checked++;
+        }
+    }
+    const char *int_rewrites[] = {"%d", "%d Hz", "%03d", "%i"};
+    const int int_values[] = {0, 7, -42, 123456};
+    for (const char *format: int_rewrites) {
+        strcpy(reused, format);
+        for (int v: int_values) {
+            mismatches += !check_int(reused, v);
+            checked++;
+        }
+    }
+
+    printf("%lld values checked, %d mismatches\n\n", checked, mismatches);
+
+    // Timing, over values a knob typically shows
+    const int count = 100000;
+    float *values = (float *) malloc(sizeof(*values) * count);
+    for (int i = 0; i < count; i++) {
+        values[i] = -6.0f + 12.0f * (float) (i % 9973) / 9972.0f;
+    }
+
+    printf("%-16s %14s %14s\n", "format", "vsnprintf ns", "FormatValue ns");
+    char buf[64];
+    volatile int sink = 0;
+    for (const char *format: float_formats) {
+        // Best of a few rounds, alternating which of the two runs first, so that neither gets a warmer cache
+        double printf_ns = 1e30, format_value_ns = 1e30;
+        for (int round = 0; round < 6; round++) {
+            auto start = std::chrono::steady_clock::now();
+            if (round % 2 == 0) {
+                for (int i = 0; i < count; i++) {
+                    sink += snprintf(buf, sizeof(buf), format, (double) values[i]);
+                }
+            } else {
+                for (int i = 0; i < count; i++) {
+                    sink += ImGuiKnobs::FormatValue(buf, sizeof(buf), ImGuiDataType_Float, &values[i], format);
+                }
+            }
+            auto ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / count;
+            auto &best = round % 2 == 0 ? printf_ns : format_value_ns;
+            best = ImMin(best, ns);
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "\"%s\"", format);
+        printf("%-16s %14.1f %14.1f\n", name, printf_ns, format_value_ns);
+    }
+    free(values);
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    Options options = parse_options(argc, argv);
+    if (options.smoother) {
+        return run_smoother(options);
+    }
+    if (options.check_format) {
+        return check_format(options);
+    }
+    setup(options);
+    ImGuiKnobs::GetConfig().mesh_cache = options.mesh_cache;
+    ImGuiKnobs::GetConfig().lod_max_error = options.lod_max_error;
+
+    char(*label_storage)[16] = (char(*)[16]) malloc(sizeof(*label_storage) * options.knobs);
+    KnobData data;
+    data.labels = (const char **) malloc(sizeof(*data.labels) * options.knobs);
+    data.values = (float *) malloc(sizeof(*data.values) * options.knobs);
+    data.mins = (float *) malloc(sizeof(*data.mins) * options.knobs);
+    data.maxes = (float *) malloc(sizeof(*data.maxes) * options.knobs);
+    data.int_values = (int *) malloc(sizeof(*data.int_values) * options.knobs);
+    data.int_mins = (int *) malloc(sizeof(*data.int_mins) * options.knobs);
+    data.int_maxes = (int *) malloc(sizeof(*data.int_maxes) * options.knobs);
+    data.handles = (ImGuiKnobs::KnobHandle *) calloc(options.knobs, sizeof(*data.handles));
+    double *frame_ns = (double *) malloc(sizeof(*frame_ns) * options.frames);
+    for (int i = 0; i < options.knobs; i++) {
+        snprintf(label_storage[i], sizeof(*label_storage), "K%04d", i);
+        data.labels[i] = label_storage[i];
+        data.values[i] = -6.0f + 12.0f * (float) (i % 97) / 96.0f;
+        data.mins[i] = -6.0f;
+        data.maxes[i] = 6.0f;
+        data.int_values[i] = i % 16;
+        data.int_mins[i] = 0;
+        data.int_maxes[i] = 15;
+    }
+
+    int result = 0;
+    if (options.check_ids) {
+        result = check_ids();
+    } else if (options.check_allocations) {
+        result = check_allocations(options, data);
+    } else if (options.overdraw) {
+        result = run_overdraw(options, data);
+    } else {
+        result = run_benchmark(options, data, frame_ns);
+    }
+
+    ImGui::DestroyContext();
+    free(label_storage);
+    free(data.labels);
+    free(data.values);
+    free(data.mins);
+    free(data.maxes);
+    free(data.int_values);
+    free(data.int_mins);
+    free(data.int_maxes);
+    free(data.handles);
+    free(frame_ns);
+
+    return result;
+}
@@ -0,0 +1,126 @@
+#include "rasterizer.h"
+#include "imgui_internal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline float edge(ImVec2 a, ImVec2 b, float x, float y) {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+// Samples exactly on an edge belong to one of the two triangles sharing it: the edge is walked in opposite
+// directions by each, and only one direction owns the samples
+static inline bool owns_edge(ImVec2 a, ImVec2 b) {
+    return b.y > a.y || (b.y == a.y && b.x < a.x);
+}
+
+static inline bool inside(float w, bool owned) {
+    return w > 0.0f || (w == 0.0f && owned);
+}
+
+OverdrawRasterizer::OverdrawRasterizer(int width, int height) : width(width), height(height) {
+    depth = (unsigned short *) calloc((size_t) width * height, sizeof(*depth));
+}
+
+OverdrawRasterizer::~OverdrawRasterizer() {
+    free(depth);
+}
+
+void OverdrawRasterizer::clear() {
+    memset(depth, 0, (size_t) width * height * sizeof(*depth));
+}
+
+void OverdrawRasterizer::draw_triangle(ImVec2 a, ImVec2 b, ImVec2 c, const ImVec4 &clip) {
+    auto area = edge(a, b, c.x, c.y);
+    if (area == 0.0f) {
+        return;
+    }
+    if (area < 0.0f) {
+        ImSwap(b, c);
+    }
+
+    // Pixels whose centers are inside the bounding box and the clip rect (which, like a scissor rect, excludes
+    // its right and bottom edges)
+    auto min_x = ImMax((int) ceilf(ImMax(ImMin(a.x, ImMin(b.x, c.x)), clip.x) - 0.5f), 0);
+    auto min_y = ImMax((int) ceilf(ImMax(ImMin(a.y, ImMin(b.y, c.y)), clip.y) - 0.5f), 0);
+    auto max_x = ImMin(ImMin((int) floorf(ImMax(a.x, ImMax(b.x, c.x)) - 0.5f) + 1, (int) ceilf(clip.z - 0.5f)), width);
+    auto max_y = ImMin(ImMin((int) floorf(ImMax(a.y, ImMax(b.y, c.y)) - 0.5f) + 1, (int) ceilf(clip.w - 0.5f)), height);
+
+    auto owns_ab = owns_edge(a, b);
+    auto owns_bc = owns_edge(b, c);
+    auto owns_ca = owns_edge(c, a);
+    for (int y = min_y; y < max_y; y++) {
+        auto *row = depth + (size_t) y * width;
+        auto sy = y + 0.5f;
+        for (int x = min_x; x < max_x; x++) {
+            auto sx = x + 0.5f;
+            if (inside(edge(a, b, sx, sy), owns_ab) && inside(edge(b, c, sx, sy), owns_bc) && inside(edge(c, a, sx, sy), owns_ca)) {
+                if (row[x] != 0xFFFF) {
+                    row[x]++;
+                }
+            }
+        }
+    }
+}
+
+void OverdrawRasterizer::draw(const ImDrawList *draw_list, int idx_start) {
+    const auto *vtx = draw_list->VtxBuffer.Data;
+    const auto *idx = draw_list->IdxBuffer.Data;
+    for (const auto &cmd: draw_list->CmdBuffer) {
+        if (cmd.UserCallback) {
+            continue;
+        }
+        auto first = ImMax((int) cmd.IdxOffset, idx_start);
+        auto end = (int) (cmd.IdxOffset + cmd.ElemCount);
+        for (int i = first; i + 2 < end; i += 3) {
+            draw_triangle(vtx[cmd.VtxOffset + idx[i]].pos, vtx[cmd.VtxOffset + idx[i + 1]].pos, vtx[cmd.VtxOffset + idx[i + 2]].pos, cmd.ClipRect);
+        }
+    }
+}
+
+void OverdrawRasterizer::draw(const ImDrawData *draw_data) {
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        draw(draw_data->CmdLists[n]);
+    }
+}
+
+OverdrawStats OverdrawRasterizer::stats() const {
+    OverdrawStats stats = {0, 0, 0};
+    for (int i = 0; i < width * height; i++) {
+        stats.fragments += depth[i];
+        stats.covered += depth[i] != 0;
+        stats.max_depth = ImMax(stats.max_depth, (int) depth[i]);
+    }
+    return stats;
+}
+
+bool OverdrawRasterizer::write_heatmap(const char *path) const {
+    int min_x = width, min_y = height, max_x = 0, max_y = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (depth[(size_t) y * width + x]) {
+                min_x = ImMin(min_x, x);
+                min_y = ImMin(min_y, y);
+                max_x = ImMax(max_x, x + 1);
+                max_y = ImMax(max_y, y + 1);
+            }
+        }
+    }
+    if (max_x <= min_x) {
+        min_x = min_y = 0;
+        max_x = max_y = 1;
+    }
+
+    auto *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P5\n%d %d\n255\n", max_x - min_x, max_y - min_y);
+    for (int y = min_y; y < max_y; y++) {
+        for (int x = min_x; x < max_x; x++) {
+            fputc(ImMin(depth[(size_t) y * width + x] * 32, 255), file);
+        }
+    }
+    return fclose(file) == 0;
+}
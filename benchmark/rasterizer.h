@@ -0,0 +1,40 @@
+#pragma once
+
+#include "imgui.h"
+
+// Headless software rasterizer for Dear ImGui draw lists, to measure how many pixels knobs fill without a GPU.
+// Triangles are sampled at pixel centers with a top-left fill rule and clipped to their command's clip rect,
+// like a GPU rasterizer would; texture and color are ignored. Every covered sample counts as one fragment, so
+// the per-pixel count is the overdraw (anti-aliasing fringes included, even where they are transparent).
+struct OverdrawStats {
+    long long fragments;// Samples shaded, the fill cost
+    long long covered;  // Pixels with at least one fragment
+    int max_depth;      // Most fragments on a single pixel
+};
+
+struct OverdrawRasterizer {
+    OverdrawRasterizer(int width, int height);
+    ~OverdrawRasterizer();
+
+    void clear();
+
+    // Adds the triangles of `draw_list` from index `idx_start` on (e.g. to leave out a window background)
+    void draw(const ImDrawList *draw_list, int idx_start = 0);
+    void draw(const ImDrawData *draw_data);
+
+    OverdrawStats stats() const;
+
+    // Writes the fragment count of each pixel as a binary PGM, cropped to the covered pixels. Each fragment
+    // adds 32 gray levels, so 8 or more overlapping layers are white.
+    bool write_heatmap(const char *path) const;
+
+    int width;
+    int height;
+    unsigned short *depth;// Fragments per pixel, row-major
+
+private:
+    void draw_triangle(ImVec2 a, ImVec2 b, ImVec2 c, const ImVec4 &clip);
+
+    OverdrawRasterizer(const OverdrawRasterizer &);
+    OverdrawRasterizer &operator=(const OverdrawRasterizer &);
+};
@@ -0,0 +1,251 @@
+#include "imgui-knobs-smoother.h"
+
+#include <cmath>
+#include <cstring>
+#include <imgui.h>
+
+// Enable SIMD intrinsics for the smoothing kernels if available
+#if !defined(IMGUIKNOBS_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define IMGUIKNOBS_SMOOTHER_ENABLE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define IMGUIKNOBS_SMOOTHER_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace ImGuiKnobs {
+    namespace detail {
+        static float *alloc_lanes(int count) {
+            auto *lanes = (float *) IM_ALLOC(sizeof(float) * count);
+            memset(lanes, 0, sizeof(float) * count);
+            return lanes;
+        }
+
+        // Scalar reference of the kernels below, used for the lanes the SIMD loops do not cover
+        static void one_pole_block_scalar(int begin, int end, float *current, const float *target, float k) {
+            for (int i = begin; i < end; i++) {
+                current[i] += (target[i] - current[i]) * k;
+            }
+        }
+
+        static void linear_block_scalar(int begin, int end, float *current, const float *target, const float *step, float *remaining, float frames) {
+            for (int i = begin; i < end; i++) {
+                auto n = remaining[i] < frames ? remaining[i] : frames;
+                current[i] += step[i] * n;
+                remaining[i] -= n;
+                if (remaining[i] <= 0.0f) {
+                    current[i] = target[i];
+                }
+            }
+        }
+
+        static void one_pole_samples_scalar(int begin, int end, float *current, const float *target, float k, int frames, float *const *outputs) {
+            for (int i = begin; i < end; i++) {
+                auto *out = outputs[i];
+                for (int s = 0; s < frames; s++) {
+                    current[i] += (target[i] - current[i]) * k;
+                    if (out) {
+                        out[s] = current[i];
+                    }
+                }
+            }
+        }
+
+        static void linear_samples_scalar(int begin, int end, float *current, const float *target, const float *step, float *remaining, int frames, float *const *outputs) {
+            for (int i = begin; i < end; i++) {
+                auto *out = outputs[i];
+                for (int s = 0; s < frames; s++) {
+                    if (remaining[i] > 0.0f) {
+                        current[i] += step[i];
+                        remaining[i] -= 1.0f;
+                        if (remaining[i] <= 0.0f) {
+                            current[i] = target[i];
+                        }
+                    }
+                    if (out) {
+                        out[s] = current[i];
+                    }
+                }
+            }
+        }
+
+#if defined(IMGUIKNOBS_SMOOTHER_ENABLE_SSE2) || defined(IMGUIKNOBS_SMOOTHER_ENABLE_NEON)
+        // Writes sample `sample` of the parameters `i`..`i + lanes` to their outputs
+        static void scatter(float *const *outputs, int i, int sample, const float *values, int lanes) {
+            for (int j = 0; j < lanes; j++) {
+                if (outputs[i + j]) {
+                    outputs[i + j][sample] = values[j];
+                }
+            }
+        }
+#endif
+    }// namespace detail
+
+    KnobSmoother::KnobSmoother(int count, ImGuiKnobSmootherMode mode, float smoothing_time, float sample_rate)
+        : Count(count), mode(mode), coefficient(0.0f), ramp_length(0.0f), padded_count((count + 3) & ~3) {
+        current = detail::alloc_lanes(padded_count);
+        target = detail::alloc_lanes(padded_count);
+        step = detail::alloc_lanes(padded_count);
+        remaining = detail::alloc_lanes(padded_count);
+        SetSmoothingTime(smoothing_time, sample_rate);
+    }
+
+    KnobSmoother::~KnobSmoother() {
+        IM_FREE(current);
+        IM_FREE(target);
+        IM_FREE(step);
+        IM_FREE(remaining);
+    }
+
+    void KnobSmoother::SetSmoothingTime(float smoothing_time, float sample_rate) {
+        auto samples = smoothing_time * sample_rate;
+        coefficient = samples > 0.0f ? expf(-1.0f / samples) : 0.0f;
+        ramp_length = samples > 1.0f ? floorf(samples) : 0.0f;
+    }
+
+    void KnobSmoother::SetTarget(int index, float value) {
+        IM_ASSERT(index >= 0 && index < Count);
+        target[index] = value;
+        if (mode == ImGuiKnobSmootherMode_Linear) {
+            if (ramp_length > 0.0f) {
+                remaining[index] = ramp_length;
+                step[index] = (value - current[index]) / ramp_length;
+            } else {
+                current[index] = value;
+                remaining[index] = 0.0f;
+            }
+        }
+    }
+
+    void KnobSmoother::SetValue(int index, float value) {
+        IM_ASSERT(index >= 0 && index < Count);
+        current[index] = value;
+        target[index] = value;
+        remaining[index] = 0.0f;
+    }
+
+    void KnobSmoother::Drain(EventQueue &queue) {
+        Event event;
+        while (queue.Pop(&event)) {
+            if ((event.flags & ImGuiKnobEventFlags_ValueChanged) && !(event.flags & ImGuiKnobEventFlags_DefaultParam) && event.param_id < (ImGuiID) Count) {
+                SetTarget((int) event.param_id, event.value);
+            }
+        }
+    }
+
+    void KnobSmoother::Process(int frames, float *const *outputs) {
+        if (frames <= 0) {
+            return;
+        }
+
+        int i = 0;
+        if (mode == ImGuiKnobSmootherMode_OnePole) {
+            auto k = outputs ? 1.0f - coefficient : 1.0f - powf(coefficient, (float) frames);
+#if defined(IMGUIKNOBS_SMOOTHER_ENABLE_SSE2)
+            const __m128 kv = _mm_set1_ps(k);
+            for (; i < padded_count; i += 4) {
+                __m128 c = _mm_loadu_ps(&current[i]);
+                const __m128 t = _mm_loadu_ps(&target[i]);
+                if (!outputs) {
+                    c = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(t, c), kv));
+                } else {
+                    alignas(16) float values[4];
+                    for (int s = 0; s < frames; s++) {
+                        c = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(t, c), kv));
+                        _mm_store_ps(values, c);
+                        detail::scatter(outputs, i, s, values, Count - i < 4 ? Count - i : 4);
+                    }
+                }
+                _mm_storeu_ps(&current[i], c);
+            }
+#elif defined(IMGUIKNOBS_SMOOTHER_ENABLE_NEON)
+            for (; i < padded_count; i += 4) {
+                float32x4_t c = vld1q_f32(&current[i]);
+                const float32x4_t t = vld1q_f32(&target[i]);
+                if (!outputs) {
+                    c = vmlaq_n_f32(c, vsubq_f32(t, c), k);
+                } else {
+                    float values[4];
+                    for (int s = 0; s < frames; s++) {
+                        c = vmlaq_n_f32(c, vsubq_f32(t, c), k);
+                        vst1q_f32(values, c);
+                        detail::scatter(outputs, i, s, values, Count - i < 4 ? Count - i : 4);
+                    }
+                }
+                vst1q_f32(&current[i], c);
+            }
+#endif
+            if (outputs) {
+                detail::one_pole_samples_scalar(i, Count, current, target, k, frames, outputs);
+            } else {
+                detail::one_pole_block_scalar(i, padded_count, current, target, k);
+            }
+            return;
+        }
+
+#if defined(IMGUIKNOBS_SMOOTHER_ENABLE_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        for (; i < padded_count; i += 4) {
+            __m128 c = _mm_loadu_ps(&current[i]);
+            __m128 r = _mm_loadu_ps(&remaining[i]);
+            const __m128 t = _mm_loadu_ps(&target[i]);
+            const __m128 d = _mm_loadu_ps(&step[i]);
+            if (!outputs) {
+                const __m128 n = _mm_min_ps(r, _mm_set1_ps((float) frames));
+                c = _mm_add_ps(c, _mm_mul_ps(d, n));
+                r = _mm_sub_ps(r, n);
+                const __m128 done = _mm_cmple_ps(r, zero);
+                c = _mm_or_ps(_mm_and_ps(done, t), _mm_andnot_ps(done, c));
+            } else {
+                const __m128 one = _mm_set1_ps(1.0f);
+                alignas(16) float values[4];
+                for (int s = 0; s < frames; s++) {
+                    const __m128 active = _mm_cmpgt_ps(r, zero);
+                    c = _mm_add_ps(c, _mm_and_ps(active, d));
+                    r = _mm_sub_ps(r, _mm_and_ps(active, one));
+                    const __m128 done = _mm_cmple_ps(r, zero);
+                    c = _mm_or_ps(_mm_and_ps(done, t), _mm_andnot_ps(done, c));
+                    _mm_store_ps(values, c);
+                    detail::scatter(outputs, i, s, values, Count - i < 4 ? Count - i : 4);
+                }
+            }
+            _mm_storeu_ps(&current[i], c);
+            _mm_storeu_ps(&remaining[i], r);
+        }
+#elif defined(IMGUIKNOBS_SMOOTHER_ENABLE_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        for (; i < padded_count; i += 4) {
+            float32x4_t c = vld1q_f32(&current[i]);
+            float32x4_t r = vld1q_f32(&remaining[i]);
+            const float32x4_t t = vld1q_f32(&target[i]);
+            const float32x4_t d = vld1q_f32(&step[i]);
+            if (!outputs) {
+                const float32x4_t n = vminq_f32(r, vdupq_n_f32((float) frames));
+                c = vmlaq_f32(c, d, n);
+                r = vsubq_f32(r, n);
+                c = vbslq_f32(vcleq_f32(r, zero), t, c);
+            } else {
+                float values[4];
+                for (int s = 0; s < frames; s++) {
+                    const uint32x4_t active = vcgtq_f32(r, zero);
+                    c = vbslq_f32(active, vaddq_f32(c, d), c);
+                    r = vbslq_f32(active, vsubq_f32(r, vdupq_n_f32(1.0f)), r);
+                    c = vbslq_f32(vcleq_f32(r, zero), t, c);
+                    vst1q_f32(values, c);
+                    detail::scatter(outputs, i, s, values, Count - i < 4 ? Count - i : 4);
+                }
+            }
+            vst1q_f32(&current[i], c);
+            vst1q_f32(&remaining[i], r);
+        }
+#endif
+        if (outputs) {
+            detail::linear_samples_scalar(i, Count, current, target, step, remaining, frames, outputs);
+        } else {
+            detail::linear_block_scalar(i, padded_count, current, target, step, remaining, (float) frames);
+        }
+    }
+
+}// namespace ImGuiKnobs
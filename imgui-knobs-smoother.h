@@ -0,0 +1,63 @@
+#pragma once
+
+#include "imgui-knobs.h"
+
+typedef int ImGuiKnobSmootherMode;
+
+enum ImGuiKnobSmootherMode_ {
+    ImGuiKnobSmootherMode_OnePole,// Exponential approach, reaches ~63% of a change after the smoothing time
+    ImGuiKnobSmootherMode_Linear, // Linear ramp that reaches the target after exactly the smoothing time
+};
+
+namespace ImGuiKnobs {
+
+    // Parameter smoothing for the audio thread. Knob changes arrive at frame rate; the smoother turns them into
+    // ramps so that the audio does not step between frames. State is kept as one array per field and all
+    // parameters are advanced together, four at a time with SSE2/NEON.
+    //
+    // Parameter `i` listens to the events with param_id `i`, so the knobs must be given their param_id with
+    // SetNextKnobParam(). Events of knobs drawn without it carry ImGuiKnobEventFlags_DefaultParam and are skipped,
+    // as are events whose param_id is not below Count.
+    struct KnobSmoother {
+        KnobSmoother(int count, ImGuiKnobSmootherMode mode, float smoothing_time, float sample_rate);
+        ~KnobSmoother();
+
+        // Changes the ramp of parameters set from now on
+        void SetSmoothingTime(float smoothing_time, float sample_rate);
+
+        // Starts moving parameter `index` towards `value`
+        void SetTarget(int index, float value);
+
+        // Sets parameter `index` to `value` without smoothing
+        void SetValue(int index, float value);
+
+        // Applies the ValueChanged events of `queue` as new targets. Call once per block, before Process().
+        void Drain(EventQueue &queue);
+
+        // Advances all parameters by `frames` samples. When `outputs` is not NULL, outputs[i] receives the
+        // `frames` smoothed values of parameter i (entries may be NULL to skip a parameter). Without outputs
+        // only the values at the end of the block are computed, which costs the same for any block size.
+        void Process(int frames, float *const *outputs = NULL);
+
+        // Smoothed values at the end of the last processed block
+        const float *Values() const { return current; }
+
+        int Count;
+
+    private:
+        ImGuiKnobSmootherMode mode;
+        float coefficient;// One-pole feedback per sample
+        float ramp_length;// Linear ramp length in samples
+
+        // Padded to a multiple of 4 parameters
+        int padded_count;
+        float *current;
+        float *target;
+        float *step;     // Linear: change per sample
+        float *remaining;// Linear: samples left in the ramp
+
+        KnobSmoother(const KnobSmoother &);
+        KnobSmoother &operator=(const KnobSmoother &);
+    };
+
+}// namespace ImGuiKnobs
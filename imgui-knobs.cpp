@@ -1,348 +1,2987 @@
 #include "imgui-knobs.h"
 
+#include <cfloat>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <imgui.h>
 #include <imgui_internal.h>
 
 #define IMGUIKNOBS_PI 3.14159265358979323846f
 
+// Enable SIMD intrinsics for the mesh vertex transform if available
+#if !defined(IMGUIKNOBS_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define IMGUIKNOBS_ENABLE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define IMGUIKNOBS_ENABLE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define IMGUIKNOBS_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 static inline float ImLog(int x) { return ImLog(static_cast<float>(x)); }
 
 namespace ImGuiKnobs {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+    int Stats::VariantIndex(ImGuiKnobVariant variant) {
+        for (int i = 0; i < VariantCount; i++) {
+            if (variant == 1 << i) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    StatsCounters Stats::Total(ImGuiKnobVariant variant) const {
+        StatsCounters total = {0, 0, 0, 0};
+        auto index = VariantIndex(variant);
+        if (index < 0) {
+            return total;
+        }
+        for (const auto &c: counters[index]) {
+            total.calls += c.calls;
+            total.vertices += c.vertices;
+            total.indices += c.indices;
+            total.path_points += c.path_points;
+        }
+        return total;
+    }
+
+    StatsCounters Stats::Total() const {
+        StatsCounters total = {0, 0, 0, 0};
+        for (int i = 0; i < VariantCount; i++) {
+            auto c = Total(1 << i);
+            total.calls += c.calls;
+            total.vertices += c.vertices;
+            total.indices += c.indices;
+            total.path_points += c.path_points;
+        }
+        return total;
+    }
+#endif
+
     namespace detail {
-        void draw_arc(ImVec2 center, float radius, float start_angle, float end_angle, float thickness, ImColor color) {
-            auto *draw_list = ImGui::GetWindowDrawList();
+#ifdef IMGUIKNOBS_ENABLE_STATS
+        static Stats stats = {-1};
+        static int stats_variant = -1;
 
-            draw_list->PathArcTo(center, radius, start_angle, end_angle);
-            draw_list->PathStroke(color, 0, thickness);
+        void stats_begin_knob(ImGuiKnobVariant variant) {
+            auto frame = ImGui::GetFrameCount();
+            if (stats.frame != frame) {
+                memset(&stats, 0, sizeof(stats));
+                stats.frame = frame;
+            }
+
+            stats_variant = Stats::VariantIndex(variant);
+            if (stats_variant >= 0) {
+                stats.knobs[stats_variant]++;
+            }
         }
 
-        template<typename DataType>
-        struct knob {
-            float radius;
-            bool value_changed;
-            ImVec2 center;
-            bool is_active;
-            bool is_hovered;
+        // Records the geometry a primitive adds to the draw list between construction and destruction
+        struct stats_scope {
+            ImDrawList *draw_list;
+            int primitive;
+            int vtx_start;
+            int idx_start;
+            int path_points;
+
+            stats_scope(int _primitive, ImDrawList *_draw_list)
+                : draw_list(_draw_list), primitive(_primitive), vtx_start(_draw_list->VtxBuffer.Size), idx_start(_draw_list->IdxBuffer.Size), path_points(-1) {}
+
+            ~stats_scope() {
+                auto vertices = draw_list->VtxBuffer.Size - vtx_start;
+                if (path_points < 0) {
+                    // Filled shapes build their path internally, anti-aliased fills emit two vertices per point
+                    path_points = draw_list->Flags & ImDrawListFlags_AntiAliasedFill ? vertices / 2 : vertices;
+                }
+
+                stats_record(primitive, vertices, draw_list->IdxBuffer.Size - idx_start, path_points);
+            }
+
+            static void stats_record(int primitive, int vertices, int indices, int path_points) {
+                if (stats_variant < 0) {
+                    return;
+                }
+
+                auto &c = stats.counters[stats_variant][primitive];
+                c.calls++;
+                c.vertices += vertices;
+                c.indices += indices;
+                c.path_points += path_points;
+            }
+        };
+#endif
+
+        // Mirrors StatsPrimitive_ so geometry can be tagged without IMGUIKNOBS_ENABLE_STATS
+        enum primitive_ {
+            primitive_circle,
+            primitive_arc,
+            primitive_tick,
+            primitive_dot
+        };
+
+        // Shapes whose proportions only depend on the knob radius are tessellated once in unit space
+        // and then translated, scaled and recolored straight into the draw list. A vertex ends up at
+        // `center + pos * radius + fringe * _FringeScale`, so anti-aliasing fringes keep their on-screen
+        // width at any knob size. Colors are indices into a palette of opaque/transparent pairs.
+        enum mesh_color_ {
+            mesh_color_primary = 0,
+            mesh_color_secondary = 2,
+            mesh_color_track = 4,
+            mesh_color_modulation = 6,
+            mesh_color_transparent = 1,
+            mesh_color_COUNT = 8
+        };
+
+        enum mesh_shape_ {
+            mesh_shape_circle,
+            mesh_shape_background,
+            mesh_shape_skin
+        };
+
+        enum mesh_flags_ {
+            mesh_flags_aa_fill = 1 << 0,
+            mesh_flags_aa_lines = 1 << 1,
+            mesh_flags_thin_ticks = 1 << 2,
+            mesh_flags_thin_track = 1 << 3,
+            mesh_flags_tex_lines = 1 << 4// Lines of integer width are drawn from the baked lines of the atlas
+        };
+
+        struct mesh_key {
+            int shape;
+            ImGuiKnobVariant variant;
+            int segments;
+            int flags;
+            int steps;
             float angle_min;
             float angle_max;
-            float t;
-            float angle;
-            float angle_cos;
-            float angle_sin;
+            ImGuiID skin;
+            unsigned int thin_layers;// Skin layers thinner than the fringe, one bit per layer
+            float radius;            // Of backgrounds, whose layers get the segment counts of their own radius
+            float max_error;         // Tessellation error those segment counts were computed with
+        };
 
-            knob(const char *_label,
-                 ImGuiDataType data_type,
-                 DataType *p_value,
-                 DataType v_min,
-                 DataType v_max,
-                 float speed,
-                 float _radius,
-                 const char *format,
-                 ImGuiKnobFlags flags,
-                 float _angle_min,
-                 float _angle_max) {
-                radius = _radius;
-                if (flags & ImGuiKnobFlags_Logarithmic) {
-                    float v = ImMax(ImMin(*p_value, v_max), v_min);
-                    t = (ImLog(ImAbs(v)) - ImLog(ImAbs(v_min))) / (ImLog(ImAbs(v_max)) - ImLog(ImAbs(v_min)));
-                } else {
-                    t = ((float) *p_value - v_min) / (v_max - v_min);
-                }
-                auto screen_pos = ImGui::GetCursorScreenPos();
+        static inline ImVec2 edge_normal(ImVec2 a, ImVec2 b) {
+            auto dx = b.x - a.x;
+            auto dy = b.y - a.y;
+            auto d2 = dx * dx + dy * dy;
+            if (d2 > 0.0f) {
+                auto inv_len = ImRsqrt(d2);
+                dx *= inv_len;
+                dy *= inv_len;
+            }
+            return {dy, -dx};
+        }
 
-                // Handle dragging
-                ImGui::InvisibleButton(_label, {radius * 2.0f, radius * 2.0f});
+        static inline ImVec2 fix_normal(float x, float y) {
+            auto d2 = x * x + y * y;
+            if (d2 > 0.000001f) {
+                auto inv_len2 = ImMin(1.0f / d2, 100.0f);
+                x *= inv_len2;
+                y *= inv_len2;
+            }
+            return {x, y};
+        }
 
-                // Handle drag: if DragVertical or DragHorizontal flags are set, only the given direction is
-                // used, otherwise use the drag direction with the highest delta
-                ImGuiIO &io = ImGui::GetIO();
-                bool drag_vertical =
-                        !(flags & ImGuiKnobFlags_DragHorizontal) &&
-                        (flags & ImGuiKnobFlags_DragVertical || ImAbs(io.MouseDelta[ImGuiAxis_Y]) > ImAbs(io.MouseDelta[ImGuiAxis_X]));
+        struct mesh {
+            bool built = false;
+            ImVector<float> pos_x;
+            ImVector<float> pos_y;
+            ImVector<float> fringe_x;
+            ImVector<float> fringe_y;
+            ImVector<ImU8> colors;
+            ImVector<ImDrawIdx> indices;
+            ImVector<int> line_uvs;// Vertices of texture-based lines, as index << 8 | TexUvLines index << 1 | side
+#ifdef IMGUIKNOBS_ENABLE_STATS
+            struct layer {
+                int primitive;
+                int vertices;
+                int indices;
+                int path_points;
+            };
+            ImVector<layer> layers;
+#endif
 
-                auto gid = ImGui::GetID(_label);
-                ImGuiSliderFlags drag_behaviour_flags = 0;
-                if (drag_vertical) {
-                    drag_behaviour_flags |= ImGuiSliderFlags_Vertical;
-                }
-                if (flags & ImGuiKnobFlags_AlwaysClamp) {
-                    drag_behaviour_flags |= ImGuiSliderFlags_AlwaysClamp;
+            void add_vertex(ImVec2 pos, ImVec2 fringe, int color) {
+                pos_x.push_back(pos.x);
+                pos_y.push_back(pos.y);
+                fringe_x.push_back(fringe.x);
+                fringe_y.push_back(fringe.y);
+                colors.push_back((ImU8) color);
+            }
+
+            void add_triangle(int base, int a, int b, int c) {
+                indices.push_back((ImDrawIdx) (base + a));
+                indices.push_back((ImDrawIdx) (base + b));
+                indices.push_back((ImDrawIdx) (base + c));
+            }
+
+            void begin_layer() {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                layer l = {0, pos_x.Size, indices.Size, 0};
+                layers.push_back(l);
+#endif
+            }
+
+            void end_layer(int primitive, int path_points) {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                auto &l = layers.back();
+                l.primitive = primitive;
+                l.vertices = pos_x.Size - l.vertices;
+                l.indices = indices.Size - l.indices;
+                l.path_points = path_points;
+#else
+                IM_UNUSED(primitive);
+                IM_UNUSED(path_points);
+#endif
+            }
+
+            // Mirrors ImDrawList::AddConvexPolyFilled()
+            void add_convex_fill(const ImVec2 *points, int count, int color, bool aa) {
+                if (count < 3) {
+                    return;
                 }
-                if (flags & ImGuiKnobFlags_Logarithmic) {
-                    drag_behaviour_flags |= ImGuiSliderFlags_Logarithmic;
+                auto base = pos_x.Size;
+                if (!aa) {
+                    for (int i = 0; i < count; i++) {
+                        add_vertex(points[i], {0, 0}, color);
+                    }
+                    for (int i = 2; i < count; i++) {
+                        add_triangle(base, 0, i - 1, i);
+                    }
+                    return;
                 }
-                value_changed = ImGui::DragBehavior(
-                        gid,
-                        data_type,
-                        p_value,
-                        speed,
-                        &v_min,
-                        &v_max,
-                        format,
-                        drag_behaviour_flags);
 
-                angle_min = _angle_min < 0 ? IMGUIKNOBS_PI * 0.75f : _angle_min;
-                angle_max = _angle_max < 0 ? IMGUIKNOBS_PI * 2.25f : _angle_max;
+                for (int i = 2; i < count; i++) {
+                    add_triangle(base, 0, (i - 1) << 1, i << 1);
+                }
+                for (int i0 = count - 1, i1 = 0; i1 < count; i0 = i1++) {
+                    auto n0 = edge_normal(points[i0], points[i1]);
+                    auto n1 = edge_normal(points[i1], points[(i1 + 1) % count]);
+                    auto dm = fix_normal((n0.x + n1.x) * 0.5f, (n0.y + n1.y) * 0.5f);
 
-                center = {screen_pos[0] + radius, screen_pos[1] + radius};
-                is_active = ImGui::IsItemActive();
-                is_hovered = ImGui::IsItemHovered();
-                angle = angle_min + (angle_max - angle_min) * t;
-                angle_cos = cosf(angle);
-                angle_sin = sinf(angle);
+                    add_vertex(points[i1], {-dm.x * 0.5f, -dm.y * 0.5f}, color);
+                    add_vertex(points[i1], {dm.x * 0.5f, dm.y * 0.5f}, color | mesh_color_transparent);
+                    add_triangle(base, i1 << 1, i0 << 1, (i0 << 1) + 1);
+                    add_triangle(base, (i0 << 1) + 1, (i1 << 1) + 1, i1 << 1);
+                }
             }
 
-            void draw_dot(float size, float radius, float angle, color_set color, bool filled, int segments) {
-                auto dot_size = size * this->radius;
-                auto dot_radius = radius * this->radius;
+            // Mirrors ImDrawList::AddPolyline() for open paths. `thin` selects the one-pixel path ImGui takes
+            // when the stroke is not wider than the fringe, and `texture_width` (if not 0) the path drawing the
+            // stroke from the atlas line of that width. `offset` is a fixed offset in fringe units.
+            void add_polyline(const ImVec2 *points, int count, float thickness, bool thin, int texture_width, ImVec2 offset, int color, bool aa) {
+                if (count < 2) {
+                    return;
+                }
+                auto base = pos_x.Size;
+                auto half = thickness * 0.5f;
+                if (!aa) {
+                    for (int i = 0; i < count - 1; i++) {
+                        auto n = edge_normal(points[i], points[i + 1]);
+                        auto p1 = points[i];
+                        auto p2 = points[i + 1];
+                        add_vertex({p1.x + n.x * half, p1.y + n.y * half}, offset, color);
+                        add_vertex({p2.x + n.x * half, p2.y + n.y * half}, offset, color);
+                        add_vertex({p2.x - n.x * half, p2.y - n.y * half}, offset, color);
+                        add_vertex({p1.x - n.x * half, p1.y - n.y * half}, offset, color);
+                        add_triangle(base + i * 4, 0, 1, 2);
+                        add_triangle(base + i * 4, 0, 2, 3);
+                    }
+                    return;
+                }
 
-                ImGui::GetWindowDrawList()->AddCircleFilled(
-                        {center[0] + cosf(angle) * dot_radius,
-                         center[1] + sinf(angle) * dot_radius},
-                        dot_size,
-                        is_active ? color.active : (is_hovered ? color.hovered : color.base),
-                        segments);
+                // Texture-based lines have a fixed width in pixels (the fringe is one pixel for them), from the
+                // line to the outer edge of the texture
+                auto texture_half = texture_width * 0.5f + 1.0f;
+                for (int i = 0; i < count; i++) {
+                    ImVec2 dm;
+                    if (i == 0) {
+                        dm = edge_normal(points[0], points[1]);
+                    } else if (i == count - 1) {
+                        dm = edge_normal(points[count - 2], points[count - 1]);
+                    } else {
+                        auto n0 = edge_normal(points[i - 1], points[i]);
+                        auto n1 = edge_normal(points[i], points[i + 1]);
+                        dm = fix_normal((n0.x + n1.x) * 0.5f, (n0.y + n1.y) * 0.5f);
+                    }
+
+                    auto p = points[i];
+                    if (texture_width > 0) {
+                        line_uvs.push_back(pos_x.Size << 8 | texture_width << 1);
+                        add_vertex(p, {offset.x + dm.x * texture_half, offset.y + dm.y * texture_half}, color);
+                        line_uvs.push_back(pos_x.Size << 8 | texture_width << 1 | 1);
+                        add_vertex(p, {offset.x - dm.x * texture_half, offset.y - dm.y * texture_half}, color);
+                    } else if (thin) {
+                        add_vertex(p, offset, color);
+                        add_vertex(p, {offset.x + dm.x, offset.y + dm.y}, color | mesh_color_transparent);
+                        add_vertex(p, {offset.x - dm.x, offset.y - dm.y}, color | mesh_color_transparent);
+                    } else {
+                        ImVec2 outer = {p.x + dm.x * half, p.y + dm.y * half};
+                        ImVec2 inner = {p.x - dm.x * half, p.y - dm.y * half};
+                        add_vertex(outer, {offset.x + dm.x * 0.5f, offset.y + dm.y * 0.5f}, color | mesh_color_transparent);
+                        add_vertex(outer, {offset.x - dm.x * 0.5f, offset.y - dm.y * 0.5f}, color);
+                        add_vertex(inner, {offset.x + dm.x * 0.5f, offset.y + dm.y * 0.5f}, color);
+                        add_vertex(inner, {offset.x - dm.x * 0.5f, offset.y - dm.y * 0.5f}, color | mesh_color_transparent);
+                    }
+                }
+
+                for (int i = 0; i < count - 1; i++) {
+                    if (texture_width > 0) {
+                        auto i1 = base + i * 2;
+                        auto i2 = i1 + 2;
+                        add_triangle(0, i2 + 0, i1 + 0, i1 + 1);
+                        add_triangle(0, i2 + 1, i1 + 1, i2 + 0);
+                    } else if (thin) {
+                        auto i1 = base + i * 3;
+                        auto i2 = i1 + 3;
+                        add_triangle(0, i2 + 0, i1 + 0, i1 + 2);
+                        add_triangle(0, i1 + 2, i2 + 2, i2 + 0);
+                        add_triangle(0, i2 + 1, i1 + 1, i1 + 0);
+                        add_triangle(0, i1 + 0, i2 + 0, i2 + 1);
+                    } else {
+                        auto i1 = base + i * 4;
+                        auto i2 = i1 + 4;
+                        add_triangle(0, i2 + 1, i1 + 1, i1 + 2);
+                        add_triangle(0, i1 + 2, i2 + 2, i2 + 1);
+                        add_triangle(0, i2 + 1, i1 + 1, i1 + 0);
+                        add_triangle(0, i1 + 0, i2 + 0, i2 + 1);
+                        add_triangle(0, i2 + 2, i1 + 2, i1 + 3);
+                        add_triangle(0, i1 + 3, i2 + 3, i2 + 2);
+                    }
+                }
             }
 
-            void draw_tick(float start, float end, float width, float angle, color_set color) {
-                auto tick_start = start * radius;
-                auto tick_end = end * radius;
-                auto angle_cos = cosf(angle);
-                auto angle_sin = sinf(angle);
+            void add_circle(const ImVector<ImVec2> &points, int color, bool aa) {
+                begin_layer();
+                add_convex_fill(points.Data, points.Size, color, aa);
+                end_layer(primitive_circle, points.Size);
+            }
 
-                ImGui::GetWindowDrawList()->AddLine(
-                        {center[0] + angle_cos * tick_end, center[1] + angle_sin * tick_end},
-                        {center[0] + angle_cos * tick_start,
-                         center[1] + angle_sin * tick_start},
-                        is_active ? color.active : (is_hovered ? color.hovered : color.base),
-                        width * radius);
+            void add_arc(const ImVector<ImVec2> &points, float size, bool thin, int texture_width, int color, bool aa) {
+                begin_layer();
+                add_polyline(points.Data, points.Size, size * 0.5f, thin, texture_width, {0, 0}, color, aa);
+                end_layer(primitive_arc, points.Size);
             }
 
-            void draw_circle(float size, color_set color, bool filled, int segments) {
-                auto circle_radius = size * radius;
+            void add_tick(float start, float end, float width, ImVec2 direction, bool thin, int texture_width, int color, bool aa) {
+                ImVec2 points[2] = {{direction.x * end, direction.y * end}, {direction.x * start, direction.y * start}};
 
-                ImGui::GetWindowDrawList()->AddCircleFilled(
-                        center,
-                        circle_radius,
-                        is_active ? color.active : (is_hovered ? color.hovered : color.base));
+                // ImDrawList::AddLine() strokes through pixel centers
+                begin_layer();
+                add_polyline(points, 2, width, thin, texture_width, {0.5f, 0.5f}, color, aa);
+                end_layer(primitive_tick, 2);
             }
 
-            void draw_arc(float radius, float size, float start_angle, float end_angle, color_set color) {
-                auto track_radius = radius * this->radius;
-                auto track_size = size * this->radius * 0.5f + 0.0001f;
+            void draw(ImDrawList *draw_list, ImVec2 center, float radius, const ImU32 *palette) const {
+                auto vtx_count = pos_x.Size;
+                auto idx_count = indices.Size;
+                draw_list->PrimReserve(idx_count, vtx_count);
+
+                transform_vertices(draw_list->_VtxWritePtr, center, radius, draw_list->_FringeScale, draw_list->_Data->TexUvWhitePixel, palette);
+                if (line_uvs.Size > 0) {
+                    const auto *lines = draw_list->_Data->TexUvLines;
+                    for (auto v: line_uvs) {
+                        const auto &uv = lines[(v >> 1) & 127];
+                        draw_list->_VtxWritePtr[v >> 8].uv = v & 1 ? ImVec2(uv.z, uv.w) : ImVec2(uv.x, uv.y);
+                    }
+                }
+
+                auto base = (ImDrawIdx) draw_list->_VtxCurrentIdx;
+                auto *idx = draw_list->_IdxWritePtr;
+                for (int i = 0; i < idx_count; i++) {
+                    idx[i] = (ImDrawIdx) (base + indices[i]);
+                }
 
-                detail::draw_arc(center, track_radius, start_angle, end_angle, track_size, is_active ? color.active : (is_hovered ? color.hovered : color.base));
+                draw_list->_VtxWritePtr += vtx_count;
+                draw_list->_IdxWritePtr += idx_count;
+                draw_list->_VtxCurrentIdx += vtx_count;
             }
-        };
 
-        template<typename DataType>
-        knob<DataType> knob_with_drag(
-                const char *label,
-                ImGuiDataType data_type,
-                DataType *p_value,
-                DataType v_min,
-                DataType v_max,
-                float _speed,
-                const char *format,
-                float size,
-                ImGuiKnobFlags flags,
-                float angle_min,
-                float angle_max) {
-            if (flags & ImGuiKnobFlags_Logarithmic && v_min <= 0.0 && v_max >= 0.0) {
-                // we must handle the cornercase if a client specifies a logarithmic range that contains zero
-                // for this we clamp lower limit to avoid hitting zero like it is done in ImGui::SliderBehaviorT
-                const bool is_floating_point = (data_type == ImGuiDataType_Float) || (data_type == ImGuiDataType_Double);
-                const int decimal_precision = is_floating_point ? ImParseFormatPrecision(format, 3) : 1;
-                v_min = ImPow(0.1f, (float) decimal_precision);
-                v_max = ImMax(v_min, v_max); // this ensures that in the cornercase v_max is still at least ge v_min
-                *p_value = ImMax(ImMin(*p_value, v_max), v_min); // this ensures that in the cornercase p_value is within the range
+            // Reference implementation, also used for the tail the vector kernels leave over
+            void transform_vertices_scalar(ImDrawVert *vtx, int begin, ImVec2 center, float radius, float fringe, ImVec2 uv, const ImU32 *palette) const {
+                for (int i = begin; i < pos_x.Size; i++) {
+                    vtx[i].pos.x = center.x + pos_x[i] * radius + fringe_x[i] * fringe;
+                    vtx[i].pos.y = center.y + pos_y[i] * radius + fringe_y[i] * fringe;
+                    vtx[i].uv = uv;
+                    vtx[i].col = palette[colors[i]];
+                }
             }
 
-            auto speed = _speed == 0 ? (v_max - v_min) / 250.f : _speed;
-            ImGui::PushID(label);
+            void transform_vertices(ImDrawVert *vtx, ImVec2 center, float radius, float fringe, ImVec2 uv, const ImU32 *palette) const {
+                int i = 0;
 
-#if IMGUI_VERSION_NUM < 19197
-            auto font_scale = ImGui::GetIO().FontGlobalScale;
-#else
-            auto font_scale = ImGui::GetStyle().FontScaleMain;
+#if defined(IMGUIKNOBS_ENABLE_AVX2)
+                const int count = pos_x.Size;
+                const __m256 cx = _mm256_set1_ps(center.x);
+                const __m256 cy = _mm256_set1_ps(center.y);
+                const __m256 r = _mm256_set1_ps(radius);
+                const __m256 f = _mm256_set1_ps(fringe);
+                for (; i + 8 <= count; i += 8) {
+                    __m256 x = _mm256_add_ps(cx, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&pos_x[i]), r), _mm256_mul_ps(_mm256_loadu_ps(&fringe_x[i]), f)));
+                    __m256 y = _mm256_add_ps(cy, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&pos_y[i]), r), _mm256_mul_ps(_mm256_loadu_ps(&fringe_y[i]), f)));
+
+                    // Interleave into (x, y) pairs: lo holds vertices 0, 1, 4, 5 and hi holds 2, 3, 6, 7
+                    __m256 lo = _mm256_unpacklo_ps(x, y);
+                    __m256 hi = _mm256_unpackhi_ps(x, y);
+                    __m128 lo0 = _mm256_castps256_ps128(lo);
+                    __m128 hi0 = _mm256_castps256_ps128(hi);
+                    __m128 lo1 = _mm256_extractf128_ps(lo, 1);
+                    __m128 hi1 = _mm256_extractf128_ps(hi, 1);
+                    _mm_storel_pi((__m64 *) &vtx[i + 0].pos, lo0);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 1].pos, lo0);
+                    _mm_storel_pi((__m64 *) &vtx[i + 2].pos, hi0);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 3].pos, hi0);
+                    _mm_storel_pi((__m64 *) &vtx[i + 4].pos, lo1);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 5].pos, lo1);
+                    _mm_storel_pi((__m64 *) &vtx[i + 6].pos, hi1);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 7].pos, hi1);
+                    for (int j = 0; j < 8; j++) {
+                        vtx[i + j].uv = uv;
+                        vtx[i + j].col = palette[colors[i + j]];
+                    }
+                }
+#elif defined(IMGUIKNOBS_ENABLE_SSE2)
+                const int count = pos_x.Size;
+                const __m128 cx = _mm_set1_ps(center.x);
+                const __m128 cy = _mm_set1_ps(center.y);
+                const __m128 r = _mm_set1_ps(radius);
+                const __m128 f = _mm_set1_ps(fringe);
+                for (; i + 4 <= count; i += 4) {
+                    __m128 x = _mm_add_ps(cx, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&pos_x[i]), r), _mm_mul_ps(_mm_loadu_ps(&fringe_x[i]), f)));
+                    __m128 y = _mm_add_ps(cy, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&pos_y[i]), r), _mm_mul_ps(_mm_loadu_ps(&fringe_y[i]), f)));
+                    __m128 lo = _mm_unpacklo_ps(x, y);
+                    __m128 hi = _mm_unpackhi_ps(x, y);
+                    _mm_storel_pi((__m64 *) &vtx[i + 0].pos, lo);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 1].pos, lo);
+                    _mm_storel_pi((__m64 *) &vtx[i + 2].pos, hi);
+                    _mm_storeh_pi((__m64 *) &vtx[i + 3].pos, hi);
+                    for (int j = 0; j < 4; j++) {
+                        vtx[i + j].uv = uv;
+                        vtx[i + j].col = palette[colors[i + j]];
+                    }
+                }
+#elif defined(IMGUIKNOBS_ENABLE_NEON)
+                const int count = pos_x.Size;
+                const float32x4_t cx = vdupq_n_f32(center.x);
+                const float32x4_t cy = vdupq_n_f32(center.y);
+                for (; i + 4 <= count; i += 4) {
+                    float32x4_t x = vmlaq_n_f32(vmlaq_n_f32(cx, vld1q_f32(&pos_x[i]), radius), vld1q_f32(&fringe_x[i]), fringe);
+                    float32x4_t y = vmlaq_n_f32(vmlaq_n_f32(cy, vld1q_f32(&pos_y[i]), radius), vld1q_f32(&fringe_y[i]), fringe);
+                    float32x4x2_t xy = vzipq_f32(x, y);
+                    vst1_f32(&vtx[i + 0].pos.x, vget_low_f32(xy.val[0]));
+                    vst1_f32(&vtx[i + 1].pos.x, vget_high_f32(xy.val[0]));
+                    vst1_f32(&vtx[i + 2].pos.x, vget_low_f32(xy.val[1]));
+                    vst1_f32(&vtx[i + 3].pos.x, vget_high_f32(xy.val[1]));
+                    for (int j = 0; j < 4; j++) {
+                        vtx[i + j].uv = uv;
+                        vtx[i + j].col = palette[colors[i + j]];
+                    }
+                }
 #endif
-            auto width = size == 0 ? ImGui::GetTextLineHeight() * 4.0f : size * font_scale;
-            ImGui::PushItemWidth(width);
 
-            ImGui::BeginGroup();
+                transform_vertices_scalar(vtx, i, center, radius, fringe, uv, palette);
+            }
+        };
 
-            // There's an issue with `SameLine` and Groups, see
-            // https://github.com/ocornut/imgui/issues/4190. This is probably not the best
-            // solution, but seems to work for now
-            ImGui::GetCurrentWindow()->DC.CurrLineTextBaseOffset = 0;
+        static ImPool<mesh> meshes;
 
-            // Draw title
-            if (!(flags & ImGuiKnobFlags_NoTitle)) {
-                auto title_size = ImGui::CalcTextSize(label, NULL, false, width);
+        // Meshes of sizes or styles that are no longer drawn are never hit again, and are dropped when the
+        // cache fills up
+        static const int mesh_cache_capacity = 1 << 10;
 
-                // Center title
-                ImGui::SetCursorPosX(ImGui::GetCursorPosX() +
-                                     (width - title_size[0]) * 0.5f);
+        // Neighbouring knobs usually share their meshes, so the last key looked up is compared before hashing
+        static mesh_key last_mesh_key;
+        static int last_mesh_index = -1;
 
-                ImGui::Text("%s", label);
-            }
+        // Bumped whenever the cache is cleared, which invalidates the indices of its meshes
+        static int mesh_generation = 0;
 
-            // Draw knob
-            knob<DataType> k(label, data_type, p_value, v_min, v_max, speed, width * 0.5f, format, flags, angle_min, angle_max);
+        static void clear_meshes() {
+            meshes.Clear();
+            last_mesh_index = -1;
+            mesh_generation++;
+        }
 
-            // Draw tooltip
-            if (flags & ImGuiKnobFlags_ValueTooltip &&
-                (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled) ||
-                 ImGui::IsItemActive())) {
-                ImGui::BeginTooltip();
-                ImGui::Text(format, *p_value);
-                ImGui::EndTooltip();
+        static mesh *find_mesh(const mesh_key &key) {
+            if (last_mesh_index >= 0 && memcmp(&key, &last_mesh_key, sizeof(key)) == 0) {
+                return meshes.GetByIndex(last_mesh_index);
+            }
+            auto id = ImHashData(&key, sizeof(key));
+            auto *m = meshes.GetByKey(id);
+            if (!m) {
+                if (meshes.GetAliveCount() >= mesh_cache_capacity) {
+                    clear_meshes();
+                }
+                m = meshes.GetOrAddByKey(id);
             }
+            last_mesh_key = key;
+            last_mesh_index = meshes.GetIndex(m);
+            return m;
+        }
 
-            // Draw input
-            if (!(flags & ImGuiKnobFlags_NoInput)) {
-                ImGuiSliderFlags drag_scalar_flags = 0;
-                if (flags & ImGuiKnobFlags_AlwaysClamp) {
-                    drag_scalar_flags |= ImGuiSliderFlags_AlwaysClamp;
+        struct tick_key {
+            int steps;
+            float angle_min;
+            float angle_max;
+        };
+
+        // Unit-circle directions of the ticks of a stepped knob
+        struct tick_table {
+            bool built = false;
+            ImVector<ImVec2> directions;
+        };
+
+        static ImPool<tick_table> tick_tables;
+
+        static const int tick_table_cache_capacity = 1 << 10;
+
+        // The tick angles only depend on the step count and the angle range, so their sines and cosines
+        // are computed once per combination instead of on every frame
+        static const ImVector<ImVec2> &tick_directions(int steps, float angle_min, float angle_max) {
+            tick_key key;
+            memset(&key, 0, sizeof(key));
+            key.steps = steps;
+            key.angle_min = angle_min;
+            key.angle_max = angle_max;
+
+            auto id = ImHashData(&key, sizeof(key));
+            auto *table = tick_tables.GetByKey(id);
+            if (!table) {
+                if (tick_tables.GetAliveCount() >= tick_table_cache_capacity) {
+                    tick_tables.Clear();
                 }
-                if (flags & ImGuiKnobFlags_Logarithmic) {
-                    drag_scalar_flags |= ImGuiSliderFlags_Logarithmic;
+                table = tick_tables.GetOrAddByKey(id);
+            }
+            if (!table->built) {
+                for (auto n = 0.f; n < steps; n++) {
+                    auto a = n / (steps - 1);
+                    auto angle = angle_min + (angle_max - angle_min) * a;
+                    table->directions.push_back({cosf(angle), sinf(angle)});
                 }
-                auto changed = ImGui::DragScalar("###knob_drag", data_type, p_value, speed, &v_min, &v_max, format, drag_scalar_flags);
-                if (changed) {
-                    k.value_changed = true;
+                table->built = true;
+            }
+            return table->directions;
+        }
+
+        static int mesh_flags(const ImDrawList *draw_list) {
+            int flags = 0;
+            if (draw_list->Flags & ImDrawListFlags_AntiAliasedFill) {
+                flags |= mesh_flags_aa_fill;
+            }
+            if (draw_list->Flags & ImDrawListFlags_AntiAliasedLines) {
+                flags |= mesh_flags_aa_lines;
+                // Same condition as ImDrawList::AddPolyline(), which also needs an integer line width
+                if ((draw_list->Flags & ImDrawListFlags_AntiAliasedLinesUseTex) && draw_list->_FringeScale == 1.0f) {
+                    flags |= mesh_flags_tex_lines;
                 }
             }
+            return flags;
+        }
+
+        // Width of the atlas line ImDrawList::AddPolyline() draws a line `thickness` pixels wide with, or 0 when
+        // it tessellates the line
+        static int texture_line_width(int flags, float thickness) {
+            if (!(flags & mesh_flags_tex_lines)) {
+                return 0;
+            }
+            thickness = ImMax(thickness, 1.0f);
+            auto width = (int) thickness;
+            return width < IM_DRAWLIST_TEX_LINES_WIDTH_MAX && thickness - (float) width <= 0.00001f ? width : 0;
+        }
 
-            ImGui::EndGroup();
-            ImGui::PopItemWidth();
-            ImGui::PopID();
+        // Stroke thickness in pixels of an arc `size` knob radii wide
+        static float arc_thickness(float size, float radius) {
+            return size * radius * 0.5f + 0.0001f;
+        }
 
-            return k;
+        // Tessellation error the segment counts below are computed with
+        static float lod_max_error(const ImDrawList *draw_list) {
+            auto max_error = GetConfig().lod_max_error;
+            return max_error > 0.0f ? max_error : draw_list->_Data->CircleSegmentMaxError;
         }
 
-        color_set GetPrimaryColorSet() {
-            auto *colors = ImGui::GetStyle().Colors;
+        // Segment count passed to ImDrawList for a circle of `radius` pixels. Without an error budget this is 0,
+        // which lets ImGui pick the count and draw from its table of precomputed circle points.
+        static int lod_segments(float radius) {
+            auto max_error = GetConfig().lod_max_error;
+            return max_error > 0.0f ? IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(radius, max_error) : 0;
+        }
 
-            return {colors[ImGuiCol_ButtonActive], colors[ImGuiCol_ButtonHovered], colors[ImGuiCol_ButtonHovered]};
+        static int lod_arc_segments(float radius, float start_angle, float end_angle) {
+            auto segments = lod_segments(radius);
+            if (segments == 0) {
+                return 0;
+            }
+            auto arc_length = ImAbs(end_angle - start_angle);
+            return ImMax((int) ImCeil(segments * arc_length / (IMGUIKNOBS_PI * 2.0f)), 1);
         }
 
-        color_set GetSecondaryColorSet() {
-            auto *colors = ImGui::GetStyle().Colors;
-            auto active = ImVec4(colors[ImGuiCol_ButtonActive].x * 0.5f,
-                                 colors[ImGuiCol_ButtonActive].y * 0.5f,
-                                 colors[ImGuiCol_ButtonActive].z * 0.5f,
-                                 colors[ImGuiCol_ButtonActive].w);
+        // Circle meshes only depend on the segment count, or with an automatic one on the step ImGui takes through
+        // its table of circle points, which is stored negated
+        static int circle_mesh_segments(const ImDrawList *draw_list, float radius) {
+            auto segments = lod_segments(radius);
+            if (segments > 0) {
+                return segments;
+            }
+            return -ImClamp(IM_DRAWLIST_ARCFAST_SAMPLE_MAX / draw_list->_CalcCircleAutoSegmentCount(radius), 1, IM_DRAWLIST_ARCFAST_TABLE_SIZE / 4);
+        }
 
-            auto hovered = ImVec4(colors[ImGuiCol_ButtonHovered].x * 0.5f,
-                                  colors[ImGuiCol_ButtonHovered].y * 0.5f,
-                                  colors[ImGuiCol_ButtonHovered].z * 0.5f,
-                                  colors[ImGuiCol_ButtonHovered].w);
+        // Meshes are built from the paths ImDrawList itself emits, run on this scratch list
+        static ImDrawList path_list(NULL);
 
-            return {active, hovered, hovered};
+        static const ImVector<ImVec2> &scale_path(float scale) {
+            for (auto &point: path_list._Path) {
+                point.x *= scale;
+                point.y *= scale;
+            }
+            return path_list._Path;
         }
 
-        color_set GetTrackColorSet() {
-            auto *colors = ImGui::GetStyle().Colors;
+        // Points ImDrawList::AddCircleFilled() fills for `segments` from circle_mesh_segments(), at radius `scale`
+        static const ImVector<ImVec2> &circle_path(const ImDrawList *draw_list, int segments, float scale) {
+            path_list._Data = draw_list->_Data;
+            path_list._Path.resize(0);
+            if (segments < 0) {
+                path_list._PathArcToFastEx({0, 0}, 1.0f, 0, IM_DRAWLIST_ARCFAST_SAMPLE_MAX, -segments);
+                path_list._Path.Size--;
+            } else {
+                segments = ImClamp(segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+                path_list.PathArcTo({0, 0}, 1.0f, 0.0f, (IMGUIKNOBS_PI * 2.0f) * ((float) segments - 1.0f) / (float) segments, segments - 1);
+            }
+            return scale_path(scale);
+        }
 
-            return {colors[ImGuiCol_Button], colors[ImGuiCol_Button], colors[ImGuiCol_Button]};
+        // Points ImDrawList::PathArcTo() emits for an arc of `radius` pixels and `segments` from lod_arc_segments(),
+        // at radius `scale`
+        static const ImVector<ImVec2> &arc_path(const ImDrawList *draw_list, float radius, float start_angle, float end_angle, int segments, float scale) {
+            path_list._Data = draw_list->_Data;
+            path_list._Path.resize(0);
+            path_list.PathArcTo({0, 0}, radius, start_angle, end_angle, segments);
+            return scale_path(scale / radius);
         }
-    }// namespace detail
 
-    template<typename DataType>
-    bool BaseKnob(
-            const char *label,
-            ImGuiDataType data_type,
-            DataType *p_value,
-            DataType v_min,
-            DataType v_max,
+        void draw_arc(ImVec2 center, float radius, float start_angle, float end_angle, float thickness, ImColor color, int segments) {
+            auto *draw_list = ImGui::GetWindowDrawList();
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+            stats_scope scope(StatsPrimitive_Arc, draw_list);
+#endif
+            draw_list->PathArcTo(center, radius, start_angle, end_angle, segments);
+#ifdef IMGUIKNOBS_ENABLE_STATS
+            scope.path_points = draw_list->_Path.Size;
+#endif
+            draw_list->PathStroke(color, 0, thickness);
+        }
+
+        enum color_state_ {
+            color_state_base,
+            color_state_hovered,
+            color_state_active,
+            color_state_COUNT
+        };
+
+        // Knob colors packed once per style state instead of on every primitive. Each color role holds one
+        // value per color_state_, and `mesh` holds the full mesh palette (with fringe colors) per state.
+        struct palette {
+            ImVec4 source[3];// ImGuiCol_Button, ImGuiCol_ButtonHovered, ImGuiCol_ButtonActive
+            ImU32 primary[color_state_COUNT];
+            ImU32 secondary[color_state_COUNT];
+            ImU32 track[color_state_COUNT];
+            ImVec4 modulation_source;// ImGuiCol_PlotHistogram
+            ImU32 modulation[color_state_COUNT];
+            ImU32 mesh[color_state_COUNT][mesh_color_COUNT];
+        };
+
+        static palette cached_palette;
+        static bool cached_palette_valid = false;
+
+        static ImU32 half_brightness(const ImVec4 &color) {
+            return ImGui::ColorConvertFloat4ToU32({color.x * 0.5f, color.y * 0.5f, color.z * 0.5f, color.w});
+        }
+
+        // Returns the palette for the current style colors, resolving it again only after
+        // ImGuiCol_Button/ButtonHovered/ButtonActive/PlotHistogram changed (e.g. through PushStyleColor/PopStyleColor)
+        const palette &GetPalette() {
+            IM_STATIC_ASSERT(ImGuiCol_ButtonHovered == ImGuiCol_Button + 1 && ImGuiCol_ButtonActive == ImGuiCol_Button + 2);
+            const auto *colors = &ImGui::GetStyle().Colors[ImGuiCol_Button];
+            const auto &modulation = ImGui::GetStyle().Colors[ImGuiCol_PlotHistogram];
+            auto &p = cached_palette;
+            if (cached_palette_valid && memcmp(p.source, colors, sizeof(p.source)) == 0 &&
+                memcmp(&p.modulation_source, &modulation, sizeof(modulation)) == 0) {
+                return p;
+            }
+
+            memcpy(p.source, colors, sizeof(p.source));
+            p.modulation_source = modulation;
+            const auto &button = colors[0];
+            const auto &button_hovered = colors[1];
+            const auto &button_active = colors[2];
+
+            p.primary[color_state_base] = ImGui::ColorConvertFloat4ToU32(button_active);
+            p.primary[color_state_hovered] = ImGui::ColorConvertFloat4ToU32(button_hovered);
+            p.primary[color_state_active] = p.primary[color_state_hovered];
+
+            p.secondary[color_state_base] = half_brightness(button_active);
+            p.secondary[color_state_hovered] = half_brightness(button_hovered);
+            p.secondary[color_state_active] = p.secondary[color_state_hovered];
+
+            p.track[color_state_base] = ImGui::ColorConvertFloat4ToU32(button);
+            p.track[color_state_hovered] = p.track[color_state_base];
+            p.track[color_state_active] = p.track[color_state_base];
+
+            p.modulation[color_state_base] = ImGui::ColorConvertFloat4ToU32(modulation);
+            p.modulation[color_state_hovered] = p.modulation[color_state_base];
+            p.modulation[color_state_active] = p.modulation[color_state_base];
+
+            for (int state = 0; state < color_state_COUNT; state++) {
+                auto *mesh = p.mesh[state];
+                mesh[mesh_color_primary] = p.primary[state];
+                mesh[mesh_color_secondary] = p.secondary[state];
+                mesh[mesh_color_track] = p.track[state];
+                mesh[mesh_color_modulation] = p.modulation[state];
+                for (int i = 0; i < mesh_color_COUNT; i += 2) {
+                    mesh[i | mesh_color_transparent] = mesh[i] & ~IM_COL32_A_MASK;
+                }
+            }
+
+            cached_palette_valid = true;
+            return p;
+        }
+
+        void draw_circle_mesh(int primitive, ImVec2 center, float radius, ImU32 color) {
+            if ((color & IM_COL32_A_MASK) == 0 || radius < 0.5f) {
+                return;
+            }
+
+            auto *draw_list = ImGui::GetWindowDrawList();
+            mesh_key key;
+            memset(&key, 0, sizeof(key));
+            key.shape = mesh_shape_circle;
+            key.segments = circle_mesh_segments(draw_list, radius);
+            key.flags = mesh_flags(draw_list) & mesh_flags_aa_fill;
+
+            auto *m = find_mesh(key);
+            if (!m->built) {
+                m->add_circle(circle_path(draw_list, key.segments, 1.0f), mesh_color_primary, key.flags != 0);
+                m->built = true;
+            }
+
+            ImU32 palette[mesh_color_COUNT] = {color, color & ~IM_COL32_A_MASK};
+#ifdef IMGUIKNOBS_ENABLE_STATS
+            stats_scope scope(primitive, draw_list);
+#else
+            IM_UNUSED(primitive);
+#endif
+            m->draw(draw_list, center, radius, palette);
+        }
+
+        // Everything building a background mesh needs, decoded once from its key. Layers get the circle points
+        // and line paths draw_circle(), draw_arc() and draw_tick() would use at the knob radius.
+        struct background_build {
+            const ImDrawList *draw_list;
+            float radius;
+            int flags;
+            int steps;
+            float angle_min;
+            float angle_max;
+            bool aa_fill;
+            bool aa_lines;
+            bool thin_track;
+            bool thin_ticks;
+
+            background_build(const mesh_key &key, const ImDrawList *draw_list)
+                : draw_list(draw_list), radius(key.radius), flags(key.flags), steps(key.steps), angle_min(key.angle_min), angle_max(key.angle_max),
+                  aa_fill((key.flags & mesh_flags_aa_fill) != 0), aa_lines((key.flags & mesh_flags_aa_lines) != 0),
+                  thin_track((key.flags & mesh_flags_thin_track) != 0), thin_ticks((key.flags & mesh_flags_thin_ticks) != 0) {}
+
+            const ImVector<ImVec2> &circle(float size) const {
+                // ImDrawList::AddCircleFilled() draws nothing below half a pixel
+                if (size * radius < 0.5f) {
+                    path_list._Path.resize(0);
+                    return path_list._Path;
+                }
+                return circle_path(draw_list, circle_mesh_segments(draw_list, size * radius), size);
+            }
+
+            const ImVector<ImVec2> &arc(float size) const {
+                return arc_path(draw_list, size * radius, angle_min, angle_max, lod_arc_segments(size * radius, angle_min, angle_max), size);
+            }
+
+            int arc_texture(float size) const {
+                return texture_line_width(flags, arc_thickness(size, radius));
+            }
+
+            int tick_texture(float width) const {
+                return texture_line_width(flags, width * radius);
+            }
+        };
+
+        // Geometry of each variant, as fractions of the knob radius. build() adds the parts that do not depend
+        // on the value to a background mesh, static_layers() lists them as skin layers for baking; draw() draws
+        // the rest, and everything when `background` is false.
+        template<ImGuiKnobVariant Variant>
+        struct recipe;
+
+        template<>
+        struct recipe<ImGuiKnobVariant_Tick> {
+            static constexpr float body_radius = 0.85f;
+            static constexpr float tick_start = 0.5f;
+            static constexpr float tick_end = 0.85f;
+            static constexpr float tick_width = 0.08f;
+
+            static void build(mesh &m, const background_build &b) {
+                m.add_circle(b.circle(body_radius), mesh_color_secondary, b.aa_fill);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Circle, ImGuiKnobSkinColor_Secondary, body_radius);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool background, bool) {
+                if (!background) {
+                    k.draw_circle(body_radius, colors.secondary);
+                }
+                k.draw_tick(tick_start, tick_end, tick_width, {k.angle_cos, k.angle_sin}, colors.primary);
+            }
+        };
+
+        template<>
+        struct recipe<ImGuiKnobVariant_Dot> {
+            static constexpr float body_radius = 0.85f;
+            static constexpr float dot_size = 0.12f;
+            static constexpr float dot_radius = 0.6f;
+
+            static void build(mesh &m, const background_build &b) {
+                m.add_circle(b.circle(body_radius), mesh_color_secondary, b.aa_fill);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Circle, ImGuiKnobSkinColor_Secondary, body_radius);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool background, bool) {
+                if (!background) {
+                    k.draw_circle(body_radius, colors.secondary);
+                }
+                k.draw_dot(dot_size, dot_radius, k.angle, colors.primary);
+            }
+        };
+
+        template<>
+        struct recipe<ImGuiKnobVariant_Wiper> {
+            static constexpr float body_radius = 0.7f;
+            static constexpr float track_radius = 0.8f;
+            static constexpr float track_size = 0.41f;
+            static constexpr float wiper_size = 0.43f;
+            static constexpr float modulation_size = 0.12f;
+
+            static void build(mesh &m, const background_build &b) {
+                m.add_circle(b.circle(body_radius), mesh_color_secondary, b.aa_fill);
+                m.add_arc(b.arc(track_radius), track_size, b.thin_track, b.arc_texture(track_size), mesh_color_track, b.aa_lines);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Circle, ImGuiKnobSkinColor_Secondary, body_radius);
+                layers.Add(ImGuiKnobSkinLayer_Track, ImGuiKnobSkinColor_Track, track_radius, track_size);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool background, bool) {
+                if (!background) {
+                    k.draw_circle(body_radius, colors.secondary);
+                    k.draw_arc(track_radius, track_size, k.angle_min, k.angle_max, colors.track);
+                }
+                if (k.t > 0.01f) {
+                    k.draw_arc(track_radius, wiper_size, k.angle_min, k.angle, colors.primary);
+                }
+                k.draw_modulation(track_radius, modulation_size, colors.modulation);
+            }
+        };
+
+        template<>
+        struct recipe<ImGuiKnobVariant_WiperOnly> {
+            static constexpr float track_radius = 0.8f;
+            static constexpr float track_size = 0.41f;
+            static constexpr float wiper_size = 0.43f;
+            static constexpr float modulation_size = 0.12f;
+
+            static void build(mesh &m, const background_build &b) {
+                m.add_arc(b.arc(track_radius), track_size, b.thin_track, b.arc_texture(track_size), mesh_color_track, b.aa_lines);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Track, ImGuiKnobSkinColor_Track, track_radius, track_size);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool background, bool) {
+                if (!background) {
+                    k.draw_arc(track_radius, track_size, k.angle_min, k.angle_max, colors.track);
+                }
+                if (k.t > 0.01f) {
+                    k.draw_arc(track_radius, wiper_size, k.angle_min, k.angle, colors.primary);
+                }
+                k.draw_modulation(track_radius, modulation_size, colors.modulation);
+            }
+        };
+
+        template<>
+        struct recipe<ImGuiKnobVariant_WiperDot> {
+            static constexpr float body_radius = 0.6f;
+            static constexpr float track_radius = 0.85f;
+            static constexpr float track_size = 0.41f;
+            static constexpr float dot_size = 0.1f;
+            static constexpr float modulation_size = 0.12f;
+
+            static void build(mesh &m, const background_build &b) {
+                m.add_circle(b.circle(body_radius), mesh_color_secondary, b.aa_fill);
+                m.add_arc(b.arc(track_radius), track_size, b.thin_track, b.arc_texture(track_size), mesh_color_track, b.aa_lines);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Circle, ImGuiKnobSkinColor_Secondary, body_radius);
+                layers.Add(ImGuiKnobSkinLayer_Track, ImGuiKnobSkinColor_Track, track_radius, track_size);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool background, bool) {
+                if (!background) {
+                    k.draw_circle(body_radius, colors.secondary);
+                    k.draw_arc(track_radius, track_size, k.angle_min, k.angle_max, colors.track);
+                }
+                k.draw_modulation(track_radius, modulation_size, colors.modulation);
+                k.draw_dot(dot_size, track_radius, k.angle, colors.primary);
+            }
+        };
+
+        template<>
+        struct recipe<ImGuiKnobVariant_Stepped> {
+            static constexpr float tick_start = 0.7f;
+            static constexpr float tick_end = 0.9f;
+            static constexpr float tick_width = 0.04f;
+            static constexpr float body_radius = 0.6f;
+            static constexpr float dot_size = 0.12f;
+            static constexpr float dot_radius = 0.4f;
+
+            static void build(mesh &m, const background_build &b) {
+                for (const auto &direction: tick_directions(b.steps, b.angle_min, b.angle_max)) {
+                    m.add_tick(tick_start, tick_end, tick_width, direction, b.thin_ticks, b.tick_texture(tick_width), mesh_color_primary, b.aa_lines);
+                }
+                m.add_circle(b.circle(body_radius), mesh_color_secondary, b.aa_fill);
+            }
+
+            static void static_layers(Skin &layers) {
+                layers.Add(ImGuiKnobSkinLayer_Ticks, ImGuiKnobSkinColor_Primary, tick_start, tick_end, tick_width);
+                layers.Add(ImGuiKnobSkinLayer_Circle, ImGuiKnobSkinColor_Secondary, body_radius);
+            }
+
+            template<typename Knob>
+            static void draw(Knob &k, int steps, const palette &colors, bool background, bool) {
+                if (!background) {
+                    for (const auto &direction: tick_directions(steps, k.angle_min, k.angle_max)) {
+                        k.draw_tick(tick_start, tick_end, tick_width, direction, colors.primary);
+                    }
+                    k.draw_circle(body_radius, colors.secondary);
+                }
+                k.draw_dot(dot_size, dot_radius, k.angle, colors.primary);
+            }
+        };
+
+        // No background: every part moves with the value
+        template<>
+        struct recipe<ImGuiKnobVariant_Space> {
+            static constexpr float body_radius = 0.3f;
+            static constexpr float body_shrink = 0.1f;// At the maximum value
+            static constexpr float arc_size = 0.15f;
+            static constexpr float inner_radius = 0.4f; // Dropped when simplified
+            static constexpr float middle_radius = 0.6f;// Dropped when simplified
+            static constexpr float outer_radius = 0.8f;
+
+            static void build(mesh &, const background_build &) {}
+            static void static_layers(Skin &) {}
+
+            template<typename Knob>
+            static void draw(Knob &k, int, const palette &colors, bool, bool simplified) {
+                k.draw_circle(body_radius - k.t * body_shrink, colors.secondary);
+                if (k.t > 0.01f) {
+                    if (!simplified) {
+                        k.draw_arc(inner_radius, arc_size, k.angle_min - 1.0f, k.angle - 1.0f, colors.primary);
+                        k.draw_arc(middle_radius, arc_size, k.angle_min + 1.0f, k.angle + 1.0f, colors.primary);
+                    }
+                    k.draw_arc(outer_radius, arc_size, k.angle_min + 3.0f, k.angle + 3.0f, colors.primary);
+                }
+            }
+        };
+
+        static void build_background(mesh &m, const mesh_key &key, const ImDrawList *draw_list) {
+            background_build b(key, draw_list);
+
+            switch (key.variant) {
+                case ImGuiKnobVariant_Tick:
+                    recipe<ImGuiKnobVariant_Tick>::build(m, b);
+                    break;
+                case ImGuiKnobVariant_Dot:
+                    recipe<ImGuiKnobVariant_Dot>::build(m, b);
+                    break;
+                case ImGuiKnobVariant_Wiper:
+                    recipe<ImGuiKnobVariant_Wiper>::build(m, b);
+                    break;
+                case ImGuiKnobVariant_WiperOnly:
+                    recipe<ImGuiKnobVariant_WiperOnly>::build(m, b);
+                    break;
+                case ImGuiKnobVariant_WiperDot:
+                    recipe<ImGuiKnobVariant_WiperDot>::build(m, b);
+                    break;
+                case ImGuiKnobVariant_Stepped:
+                    recipe<ImGuiKnobVariant_Stepped>::build(m, b);
+                    break;
+            }
+
+            m.built = true;
+        }
+
+        static bool skin_layer_is_static(ImGuiKnobSkinLayer layer) {
+            return layer == ImGuiKnobSkinLayer_Circle || layer == ImGuiKnobSkinLayer_Track || layer == ImGuiKnobSkinLayer_Ticks;
+        }
+
+        struct skin_layer_syntax {
+            const char *name;
+            ImGuiKnobSkinLayer layer;
+            int sizes;
+            ImGuiKnobSkinColor color;// Default
+        };
+
+        static const skin_layer_syntax skin_layers[] = {
+                {"circle", ImGuiKnobSkinLayer_Circle, 1, ImGuiKnobSkinColor_Secondary},
+                {"track", ImGuiKnobSkinLayer_Track, 2, ImGuiKnobSkinColor_Track},
+                {"value", ImGuiKnobSkinLayer_Value, 2, ImGuiKnobSkinColor_Primary},
+                {"modulation", ImGuiKnobSkinLayer_Modulation, 2, ImGuiKnobSkinColor_Modulation},
+                {"ticks", ImGuiKnobSkinLayer_Ticks, 3, ImGuiKnobSkinColor_Primary},
+                {"tick", ImGuiKnobSkinLayer_Tick, 3, ImGuiKnobSkinColor_Primary},
+                {"dot", ImGuiKnobSkinLayer_Dot, 2, ImGuiKnobSkinColor_Primary},
+        };
+
+        static const char *const skin_colors[ImGuiKnobSkinColor_COUNT] = {"primary", "secondary", "track", "modulation"};
+
+        static bool token_equals(const char *token, int length, const char *name) {
+            return (int) strlen(name) == length && memcmp(token, name, length) == 0;
+        }
+
+        // Parses a size such as "0.85", ".5" or "1e-2", which must span all of `token`. Unlike strtof() (and
+        // ImAtof()) the decimal point does not depend on the C locale.
+        static bool parse_skin_size(const char *token, int length, float *size) {
+            auto *p = token;
+            auto *end = token + length;
+            double mantissa = 0.0;
+            int exponent = 0;
+            int digits = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+                mantissa = mantissa * 10.0 + (*p - '0');
+            }
+            if (p < end && *p == '.') {
+                for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+                    mantissa = mantissa * 10.0 + (*p - '0');
+                    exponent--;
+                }
+            }
+            if (digits == 0) {
+                return false;
+            }
+            if (p < end && (*p == 'e' || *p == 'E')) {
+                p++;
+                auto negative = p < end && *p == '-';
+                if (p < end && (*p == '-' || *p == '+')) {
+                    p++;
+                }
+                int value = 0;
+                int value_digits = 0;
+                for (; p < end && *p >= '0' && *p <= '9'; p++, value_digits++) {
+                    value = ImMin(value * 10 + (*p - '0'), 1000);
+                }
+                if (value_digits == 0) {
+                    return false;
+                }
+                exponent += negative ? -value : value;
+            }
+            if (p != end) {
+                return false;
+            }
+
+            auto scale = ImPow(10.0, (double) ImAbs(exponent));
+            *size = (float) (exponent < 0 ? mantissa / scale : mantissa * scale);
+            return true;
+        }
+
+        // Parses one layer of a skin description, from `line` to `line_end` (comments removed)
+        static bool parse_skin_layer(Skin &skin, const char *line, const char *line_end) {
+            const char *tokens[5];
+            int lengths[5];
+            int count = 0;
+            for (auto *p = line; p < line_end;) {
+                if (ImCharIsBlankA(*p) || *p == '\r') {
+                    p++;
+                    continue;
+                }
+                if (count == IM_ARRAYSIZE(tokens)) {
+                    return false;
+                }
+                tokens[count] = p;
+                while (p < line_end && !ImCharIsBlankA(*p) && *p != '\r') {
+                    p++;
+                }
+                lengths[count] = (int) (p - tokens[count]);
+                count++;
+            }
+            if (count == 0) {
+                return true;
+            }
+
+            const skin_layer_syntax *syntax = NULL;
+            for (const auto &candidate: skin_layers) {
+                if (token_equals(tokens[0], lengths[0], candidate.name)) {
+                    syntax = &candidate;
+                }
+            }
+            if (!syntax || (count != 1 + syntax->sizes && count != 2 + syntax->sizes)) {
+                return false;
+            }
+
+            float sizes[3] = {0.0f, 0.0f, 0.0f};
+            for (int i = 0; i < syntax->sizes; i++) {
+                if (!parse_skin_size(tokens[1 + i], lengths[1 + i], &sizes[i]) || !(sizes[i] < FLT_MAX)) {
+                    return false;
+                }
+            }
+
+            auto color = syntax->color;
+            if (count == 2 + syntax->sizes) {
+                color = -1;
+                for (int i = 0; i < ImGuiKnobSkinColor_COUNT; i++) {
+                    if (token_equals(tokens[count - 1], lengths[count - 1], skin_colors[i])) {
+                        color = i;
+                    }
+                }
+                if (color < 0) {
+                    return false;
+                }
+            }
+
+            skin.Add(syntax->layer, color, sizes[0], sizes[1], sizes[2]);
+            return true;
+        }
+
+        // Skin colors map to the opaque mesh colors of the same role
+        static int skin_mesh_color(ImGuiKnobSkinColor color) {
+            IM_STATIC_ASSERT(mesh_color_primary == ImGuiKnobSkinColor_Primary * 2 && mesh_color_secondary == ImGuiKnobSkinColor_Secondary * 2);
+            IM_STATIC_ASSERT(mesh_color_track == ImGuiKnobSkinColor_Track * 2 && mesh_color_modulation == ImGuiKnobSkinColor_Modulation * 2);
+            return color * 2;
+        }
+
+        // Builds the static layers of a skin, whose ID is in the key
+        static void build_skin_background(mesh &m, const Skin &skin, const mesh_key &key, const ImDrawList *draw_list) {
+            background_build b(key, draw_list);
+
+            for (int i = 0; i < skin.StaticCount; i++) {
+                const auto &command = skin.Commands[i];
+                auto color = skin_mesh_color(command.color);
+                auto thin = (key.thin_layers & (1u << i)) != 0;
+                switch (command.layer) {
+                    case ImGuiKnobSkinLayer_Circle:
+                        m.add_circle(b.circle(command.a), color, b.aa_fill);
+                        break;
+                    case ImGuiKnobSkinLayer_Track:
+                        m.add_arc(b.arc(command.a), command.b, thin, b.arc_texture(command.b), color, b.aa_lines);
+                        break;
+                    case ImGuiKnobSkinLayer_Ticks:
+                        for (const auto &direction: tick_directions(key.steps, key.angle_min, key.angle_max)) {
+                            m.add_tick(command.a, command.b, command.c, direction, thin, b.tick_texture(command.c), color, b.aa_lines);
+                        }
+                        break;
+                }
+            }
+
+            m.built = true;
+        }
+
+        static float resolve_angle_min(float angle_min) {
+            return angle_min < 0 ? IMGUIKNOBS_PI * 0.75f : angle_min;
+        }
+
+        static float resolve_angle_max(float angle_max) {
+            return angle_max < 0 ? IMGUIKNOBS_PI * 2.25f : angle_max;
+        }
+
+        // Sets the fields of `key` the background of `variant` depends on. Returns false when it has none.
+        static bool background_key(mesh_key &key, ImGuiKnobVariant variant, int steps, float angle_min, float angle_max) {
+            key.shape = mesh_shape_background;
+            key.variant = variant;
+            switch (variant) {
+                case ImGuiKnobVariant_Tick:
+                case ImGuiKnobVariant_Dot:
+                    return true;
+                case ImGuiKnobVariant_Wiper:
+                case ImGuiKnobVariant_WiperOnly:
+                case ImGuiKnobVariant_WiperDot:
+                    key.angle_min = angle_min;
+                    key.angle_max = angle_max;
+                    return true;
+                case ImGuiKnobVariant_Stepped:
+                    key.steps = steps;
+                    key.angle_min = angle_min;
+                    key.angle_max = angle_max;
+                    return true;
+            }
+            return false;
+        }
+
+        // Same for the static layers of a skin. Returns false when it has none or too many to be keyed.
+        static bool skin_background_key(mesh_key &key, const Skin &skin, int steps, float angle_min, float angle_max) {
+            if (skin.StaticCount == 0 || skin.StaticCount > 32) {
+                return false;
+            }
+
+            key.shape = mesh_shape_skin;
+            key.skin = skin.ID;
+            key.steps = steps;
+            key.angle_min = angle_min;
+            key.angle_max = angle_max;
+            return true;
+        }
+
+#if IMGUI_VERSION_NUM < 19197
+        // A run of background layers of the same color, baked into one rectangle of the atlas
+        struct baked_rect {
+            int rect_id;
+            ImGuiKnobSkinColor color;
+            int first;// Layers [first, end)
+            int end;
+            ImVec2 uv_min;
+            ImVec2 uv_max;
+        };
+
+        struct baked_background {
+            ImFontAtlas *atlas = NULL;
+            Skin layers;
+            float radius = 0.0f;
+            int steps = 0;
+            float angle_min = 0.0f;
+            float angle_max = 0.0f;
+            int size = 0;// Width and height of the rectangles, with a pixel of margin on each side
+            ImVector<baked_rect> rects;
+            bool rendered = false;
+        };
+
+        static ImPool<baked_background> baked_backgrounds;
+
+        static ImGuiID baked_background_id(const mesh_key &key, float radius) {
+            return ImHashData(&radius, sizeof(radius), ImHashData(&key, sizeof(key)));
+        }
+
+        // Reserves the rectangles of the static layers of `layers` for knobs `width` pixels wide
+        static void bake_background(ImFontAtlas *atlas, const mesh_key &key, const Skin &layers, float width) {
+            auto radius = width * 0.5f;
+            auto *baked = baked_backgrounds.GetOrAddByKey(baked_background_id(key, radius));
+            if (baked->atlas == atlas) {
+                return;
+            }
+            IM_ASSERT(baked->atlas == NULL && "Background already baked into another atlas");
+
+            baked->atlas = atlas;
+            baked->radius = radius;
+            baked->steps = key.steps;
+            baked->angle_min = key.angle_min;
+            baked->angle_max = key.angle_max;
+            baked->size = (int) ImCeil(width) + 2;
+            for (int i = 0; i < layers.StaticCount; i++) {
+                const auto &command = layers.Commands[i];
+                baked->layers.Add(command.layer, command.color, command.a, command.b, command.c);
+                if (baked->rects.Size == 0 || baked->rects.back().color != command.color) {
+                    baked_rect rect;
+                    rect.rect_id = atlas->AddCustomRectRegular(baked->size, baked->size);
+                    rect.color = command.color;
+                    rect.first = i;
+                    rect.uv_min = rect.uv_max = ImVec2(0.0f, 0.0f);
+                    baked->rects.push_back(rect);
+                }
+                baked->rects.back().end = i + 1;
+            }
+        }
+
+        // Whether the point (x, y), relative to the center, is inside a static layer. Mirrors the meshes of
+        // build_skin_background().
+        static bool baked_layer_contains(const SkinCommand &command, float x, float y, float radius, const baked_background &baked) {
+            switch (command.layer) {
+                case ImGuiKnobSkinLayer_Circle:
+                    return x * x + y * y <= command.a * radius * command.a * radius;
+                case ImGuiKnobSkinLayer_Track: {
+                    if (ImAbs(ImSqrt(x * x + y * y) - command.a * radius) > command.b * radius * 0.25f) {
+                        return false;
+                    }
+                    auto angle = ImAtan2(y, x);
+                    while (angle < baked.angle_min) {
+                        angle += IMGUIKNOBS_PI * 2.0f;
+                    }
+                    while (angle >= baked.angle_min + IMGUIKNOBS_PI * 2.0f) {
+                        angle -= IMGUIKNOBS_PI * 2.0f;
+                    }
+                    return angle <= baked.angle_max;
+                }
+                case ImGuiKnobSkinLayer_Ticks:
+                    // Ticks are stroked through pixel centers
+                    x -= 0.5f;
+                    y -= 0.5f;
+                    for (const auto &direction: tick_directions(baked.steps, baked.angle_min, baked.angle_max)) {
+                        auto along = x * direction.x + y * direction.y;
+                        auto across = x * direction.y - y * direction.x;
+                        if (along >= command.a * radius && along <= command.b * radius && ImAbs(across) <= command.c * radius * 0.5f) {
+                            return true;
+                        }
+                    }
+                    return false;
+            }
+            return false;
+        }
+
+        // Forgets the rectangles of `baked`, which is then drawn from the mesh cache until it is baked again
+        static void drop_baked_background(baked_background &baked) {
+            baked.atlas = NULL;
+            baked.layers = Skin();
+            baked.rects.clear();
+            baked.rendered = false;
+        }
+
+        // Rasterizes the rectangles of a packed background with 4x4 samples per pixel
+        static void render_baked_background(baked_background &baked) {
+            auto *atlas = baked.atlas;
+            const int samples = 4;
+            for (auto &r: baked.rects) {
+                // After ImFontAtlas::Clear() the index may be gone or belong to another rectangle
+                const auto *rect = r.rect_id < atlas->CustomRects.Size ? atlas->GetCustomRectByIndex(r.rect_id) : NULL;
+                if (!rect || rect->Width != baked.size || rect->Height != baked.size || rect->Font != NULL) {
+                    drop_baked_background(baked);
+                    return;
+                }
+                if (!rect->IsPacked()) {
+                    baked.rendered = false;
+                    return;
+                }
+                atlas->CalcCustomRectUV(rect, &r.uv_min, &r.uv_max);
+
+                auto half = baked.size * 0.5f;
+                for (int py = 0; py < baked.size; py++) {
+                    for (int px = 0; px < baked.size; px++) {
+                        int covered = 0;
+                        for (int sy = 0; sy < samples; sy++) {
+                            for (int sx = 0; sx < samples; sx++) {
+                                auto x = px + (sx + 0.5f) / samples - half;
+                                auto y = py + (sy + 0.5f) / samples - half;
+                                for (int i = r.first; i < r.end; i++) {
+                                    if (baked_layer_contains(baked.layers.Commands[i], x, y, baked.radius, baked)) {
+                                        covered++;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+
+                        auto alpha = (unsigned char) (covered * 255 / (samples * samples));
+                        auto offset = (rect->Y + py) * atlas->TexWidth + rect->X + px;
+                        if (atlas->TexPixelsAlpha8) {
+                            atlas->TexPixelsAlpha8[offset] = alpha;
+                        }
+                        if (atlas->TexPixelsRGBA32) {
+                            atlas->TexPixelsRGBA32[offset] = IM_COL32(255, 255, 255, alpha);
+                        }
+                    }
+                }
+            }
+            baked.rendered = true;
+        }
+
+        // Index of the rendered baked background matching `key` and `radius`, -1 when there is none
+        static int find_baked_background(const mesh_key &key, float radius) {
+            if (!GetConfig().baked_backgrounds || baked_backgrounds.GetAliveCount() == 0) {
+                return -1;
+            }
+            auto *baked = baked_backgrounds.GetByKey(baked_background_id(key, radius));
+            if (!baked || !baked->rendered) {
+                return -1;
+            }
+            return baked_backgrounds.GetIndex(baked);
+        }
+
+        static void draw_baked_background(int index, ImVec2 center, int color_state) {
+            const auto *baked = baked_backgrounds.GetByIndex(index);
+            auto *draw_list = ImGui::GetWindowDrawList();
+            auto half = baked->size * 0.5f;
+            ImVec2 min(center.x - half, center.y - half);
+            ImVec2 max(center.x + half, center.y + half);
+            const auto *colors = GetPalette().mesh[color_state];
+            for (const auto &r: baked->rects) {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_scope scope(StatsPrimitive_Circle, draw_list);
+#endif
+                draw_list->AddImage(baked->atlas->TexID, min, max, r.uv_min, r.uv_max, colors[skin_mesh_color(r.color)]);
+            }
+        }
+#else
+        // Dear ImGui 1.92 replaced the custom rectangle API of the font atlas the bake writes through, so every
+        // background is drawn from the mesh cache
+        static void bake_background(ImFontAtlas *, const mesh_key &, const Skin &, float) {}
+
+        static int find_baked_background(const mesh_key &, float) {
+            return -1;
+        }
+
+        static void draw_baked_background(int, ImVec2, int) {}
+#endif
+
+        // Where the background of a variant is drawn from: the atlas, a cached mesh, or neither. It only depends on the variant, the size and the draw list flags, so KnobBank resolves it once
+        // for all its knobs.
+        struct background_source {
+            bool resolved = false;
+            mesh_key key;
+            int baked = -1;// Index into baked_backgrounds
+            bool cached = false;
+            int mesh_index = -1;// Index into meshes, valid while mesh_generation is unchanged
+            int generation = 0;
+        };
+
+        // The mesh of `source`, looked up again (and rebuilt) when the cache was cleared since it was resolved
+        static mesh *background_mesh(background_source &source, const ImDrawList *draw_list) {
+            if (source.mesh_index >= 0 && source.generation == mesh_generation) {
+                return meshes.GetByIndex(source.mesh_index);
+            }
+            auto *m = find_mesh(source.key);
+            if (!m->built) {
+                build_background(*m, source.key, draw_list);
+            }
+            source.mesh_index = meshes.GetIndex(m);
+            source.generation = mesh_generation;
+            return m;
+        }
+
+        template<typename DataType>
+        struct knob {
+            ImGuiID id;
+            float radius;
+            bool value_changed;
+            ImVec2 center;
+            bool is_active;
+            bool is_hovered;
+            bool is_visible;
+            float angle_min;
+            float angle_max;
+            float t;
+            float angle;
+            float angle_cos;
+            float angle_sin;
+            float range_min;
+            float range_max;
+            bool logarithmic;
+            bool has_modulation;
+            float modulation_angle;
+
+            knob(ImGuiID _id,
+                 ImGuiDataType data_type,
+                 DataType *p_value,
+                 DataType v_min,
+                 DataType v_max,
+                 float speed,
+                 float _radius,
+                 const char *format,
+                 ImGuiKnobFlags flags,
+                 float _angle_min,
+                 float _angle_max) {
+                id = _id;
+                radius = _radius;
+                range_min = (float) v_min;
+                range_max = (float) v_max;
+                logarithmic = (flags & ImGuiKnobFlags_Logarithmic) != 0;
+                has_modulation = false;
+                modulation_angle = 0.0f;
+                if (flags & ImGuiKnobFlags_Logarithmic) {
+                    float v = ImMax(ImMin(*p_value, v_max), v_min);
+                    t = (ImLog(ImAbs(v)) - ImLog(ImAbs(v_min))) / (ImLog(ImAbs(v_max)) - ImLog(ImAbs(v_min)));
+                } else {
+                    t = ((float) *p_value - v_min) / (v_max - v_min);
+                }
+                auto *window = ImGui::GetCurrentWindow();
+                auto screen_pos = window->DC.CursorPos;
+
+                // Handle dragging: ImGui::InvisibleButton(), with the ID given instead of hashed from a label
+                if (!window->SkipItems) {
+                    // Cannot use zero-size for InvisibleButton()
+                    ImVec2 size_arg(radius * 2.0f, radius * 2.0f);
+                    IM_ASSERT(size_arg.x != 0.0f && size_arg.y != 0.0f);
+                    auto size = ImGui::CalcItemSize(size_arg, 0.0f, 0.0f);
+                    ImRect bb(screen_pos, {screen_pos.x + size.x, screen_pos.y + size.y});
+                    ImGui::ItemSize(size);
+                    if (ImGui::ItemAdd(bb, id)) {
+                        bool hovered, held;
+                        ImGui::ButtonBehavior(bb, id, &hovered, &held);
+                    }
+                }
+
+                // Handle drag: if DragVertical or DragHorizontal flags are set, only the given direction is
+                // used, otherwise use the drag direction with the highest delta
+                ImGuiIO &io = ImGui::GetIO();
+                bool drag_vertical =
+                        !(flags & ImGuiKnobFlags_DragHorizontal) &&
+                        (flags & ImGuiKnobFlags_DragVertical || ImAbs(io.MouseDelta[ImGuiAxis_Y]) > ImAbs(io.MouseDelta[ImGuiAxis_X]));
+
+                ImGuiSliderFlags drag_behaviour_flags = 0;
+                if (drag_vertical) {
+                    drag_behaviour_flags |= ImGuiSliderFlags_Vertical;
+                }
+                if (flags & ImGuiKnobFlags_AlwaysClamp) {
+                    drag_behaviour_flags |= ImGuiSliderFlags_AlwaysClamp;
+                }
+                if (flags & ImGuiKnobFlags_Logarithmic) {
+                    drag_behaviour_flags |= ImGuiSliderFlags_Logarithmic;
+                }
+                value_changed = ImGui::DragBehavior(
+                        id,
+                        data_type,
+                        p_value,
+                        speed,
+                        &v_min,
+                        &v_max,
+                        format,
+                        drag_behaviour_flags);
+
+                angle_min = resolve_angle_min(_angle_min);
+                angle_max = resolve_angle_max(_angle_max);
+
+                center = {screen_pos[0] + radius, screen_pos[1] + radius};
+                is_active = ImGui::IsItemActive();
+                is_hovered = ImGui::IsItemHovered();
+                angle = angle_min + (angle_max - angle_min) * t;
+
+                // A clipped item (e.g. scrolled out of view) still takes part in ID and layout bookkeeping
+                // above, but there is nothing to draw
+                is_visible = !window->SkipItems && ImGui::IsItemVisible();
+                if (!is_visible) {
+                    angle_cos = angle_sin = 0.0f;
+                    return;
+                }
+
+                angle_cos = cosf(angle);
+                angle_sin = sinf(angle);
+            }
+
+            // Shows `value` (e.g. the value modulated by the audio engine) as a ring from the knob value
+            void set_modulation(float value) {
+                auto v = ImClamp(value, ImMin(range_min, range_max), ImMax(range_min, range_max));
+                float modulation_t;
+                if (logarithmic) {
+                    modulation_t = (ImLog(ImAbs(v)) - ImLog(ImAbs(range_min))) / (ImLog(ImAbs(range_max)) - ImLog(ImAbs(range_min)));
+                } else {
+                    modulation_t = (v - range_min) / (range_max - range_min);
+                }
+                has_modulation = true;
+                modulation_angle = angle_min + (angle_max - angle_min) * ImSaturate(modulation_t);
+            }
+
+            int color_state() const {
+                return is_active ? color_state_active : (is_hovered ? color_state_hovered : color_state_base);
+            }
+
+            void draw_dot(float size, float radius, float angle, const ImU32 *colors) {
+                auto dot_size = size * this->radius;
+                auto dot_radius = radius * this->radius;
+                auto dot_cos = angle == this->angle ? angle_cos : cosf(angle);
+                auto dot_sin = angle == this->angle ? angle_sin : sinf(angle);
+                ImVec2 dot_center = {center[0] + dot_cos * dot_radius, center[1] + dot_sin * dot_radius};
+
+                if (GetConfig().mesh_cache) {
+                    draw_circle_mesh(primitive_dot, dot_center, dot_size, colors[color_state()]);
+                    return;
+                }
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_scope scope(StatsPrimitive_Dot, ImGui::GetWindowDrawList());
+#endif
+                auto *draw_list = ImGui::GetWindowDrawList();
+                draw_list->AddCircleFilled(
+                        dot_center,
+                        dot_size,
+                        colors[color_state()],
+                        lod_segments(dot_size));
+            }
+
+            void draw_tick(float start, float end, float width, ImVec2 direction, const ImU32 *colors) {
+                auto tick_start = start * radius;
+                auto tick_end = end * radius;
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_scope scope(StatsPrimitive_Tick, ImGui::GetWindowDrawList());
+                scope.path_points = 2;
+#endif
+                ImGui::GetWindowDrawList()->AddLine(
+                        {center[0] + direction.x * tick_end, center[1] + direction.y * tick_end},
+                        {center[0] + direction.x * tick_start,
+                         center[1] + direction.y * tick_start},
+                        colors[color_state()],
+                        width * radius);
+            }
+
+            void draw_circle(float size, const ImU32 *colors) {
+                auto circle_radius = size * radius;
+
+                if (GetConfig().mesh_cache) {
+                    draw_circle_mesh(primitive_circle, center, circle_radius, colors[color_state()]);
+                    return;
+                }
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_scope scope(StatsPrimitive_Circle, ImGui::GetWindowDrawList());
+#endif
+                auto *draw_list = ImGui::GetWindowDrawList();
+                draw_list->AddCircleFilled(
+                        center,
+                        circle_radius,
+                        colors[color_state()],
+                        lod_segments(circle_radius));
+            }
+
+            void draw_arc(float radius, float size, float start_angle, float end_angle, const ImU32 *colors) {
+                auto track_radius = radius * this->radius;
+                auto track_size = arc_thickness(size, this->radius);
+
+                auto segments = lod_arc_segments(track_radius, start_angle, end_angle);
+
+                detail::draw_arc(center, track_radius, start_angle, end_angle, track_size, colors[color_state()], segments);
+            }
+
+            // Ring along the track between the value and the modulated value
+            void draw_modulation(float radius, float size, const ImU32 *colors) {
+                if (has_modulation && ImAbs(modulation_angle - angle) > 0.001f) {
+                    draw_arc(radius, size, angle, modulation_angle, colors);
+                }
+            }
+
+            // Looks up the background of `variant` at the radius of the knob
+            background_source resolve_background(ImGuiKnobVariant variant, int steps) const {
+                background_source source;
+                source.resolved = true;
+                memset(&source.key, 0, sizeof(source.key));
+                if (!background_key(source.key, variant, steps, angle_min, angle_max)) {
+                    return source;
+                }
+                source.baked = find_baked_background(source.key, radius);
+                if (source.baked >= 0 || !GetConfig().mesh_cache) {
+                    return source;
+                }
+
+                auto *draw_list = ImGui::GetWindowDrawList();
+                source.key.radius = radius;
+                source.key.max_error = lod_max_error(draw_list);
+                source.key.flags = mesh_flags(draw_list);
+
+                // All wiper variants share the track size
+                IM_STATIC_ASSERT(recipe<ImGuiKnobVariant_WiperOnly>::track_size == recipe<ImGuiKnobVariant_Wiper>::track_size);
+                IM_STATIC_ASSERT(recipe<ImGuiKnobVariant_WiperDot>::track_size == recipe<ImGuiKnobVariant_Wiper>::track_size);
+                auto wiper = variant == ImGuiKnobVariant_Wiper || variant == ImGuiKnobVariant_WiperOnly || variant == ImGuiKnobVariant_WiperDot;
+                if (wiper && arc_thickness(recipe<ImGuiKnobVariant_Wiper>::track_size, radius) <= draw_list->_FringeScale) {
+                    source.key.flags |= mesh_flags_thin_track;
+                }
+                if (variant == ImGuiKnobVariant_Stepped && recipe<ImGuiKnobVariant_Stepped>::tick_width * radius <= draw_list->_FringeScale) {
+                    source.key.flags |= mesh_flags_thin_ticks;
+                }
+
+                source.cached = true;
+                background_mesh(source, draw_list);
+                return source;
+            }
+
+            // Draws the parts of a variant that do not depend on the value from the atlas or a cached mesh,
+            // resolving `source` first unless a knob of the same size already did. Returns false when neither is
+            // available or the variant has no such parts.
+            bool draw_background(ImGuiKnobVariant variant, int steps, background_source &source) {
+                if (!source.resolved) {
+                    source = resolve_background(variant, steps);
+                }
+                if (source.baked >= 0) {
+                    draw_baked_background(source.baked, center, color_state());
+                    return true;
+                }
+                if (!source.cached) {
+                    return false;
+                }
+
+                auto *draw_list = ImGui::GetWindowDrawList();
+                auto *m = background_mesh(source, draw_list);
+                m->draw(draw_list, center, radius, GetPalette().mesh[color_state()]);
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                for (const auto &l: m->layers) {
+                    stats_scope::stats_record(l.primitive, l.vertices, l.indices, l.path_points);
+                }
+#endif
+                return true;
+            }
+
+            // Draws the static layers of a skin from the atlas or a cached mesh. Returns false when neither is
+            // available or the skin has too many static layers to be keyed.
+            bool draw_skin_background(const Skin &skin, int steps) {
+                mesh_key key;
+                memset(&key, 0, sizeof(key));
+                if (!skin_background_key(key, skin, steps, angle_min, angle_max)) {
+                    return false;
+                }
+                auto baked = find_baked_background(key, radius);
+                if (baked >= 0) {
+                    draw_baked_background(baked, center, color_state());
+                    return true;
+                }
+                if (!GetConfig().mesh_cache) {
+                    return false;
+                }
+
+                auto *draw_list = ImGui::GetWindowDrawList();
+                key.radius = radius;
+                key.max_error = lod_max_error(draw_list);
+                key.flags = mesh_flags(draw_list);
+                for (int i = 0; i < skin.StaticCount; i++) {
+                    const auto &command = skin.Commands[i];
+                    auto thickness = command.layer == ImGuiKnobSkinLayer_Track ? arc_thickness(command.b, radius) : command.c * radius;
+                    if (command.layer != ImGuiKnobSkinLayer_Circle && thickness <= draw_list->_FringeScale) {
+                        key.thin_layers |= 1u << i;
+                    }
+                }
+
+                auto *m = find_mesh(key);
+                if (!m->built) {
+                    build_skin_background(*m, skin, key, draw_list);
+                }
+
+                m->draw(draw_list, center, radius, GetPalette().mesh[color_state()]);
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                for (const auto &l: m->layers) {
+                    stats_scope::stats_record(l.primitive, l.vertices, l.indices, l.path_points);
+                }
+#endif
+                return true;
+            }
+        };
+
+        // Whether the knobs of the current frame need another frame, see NeedsRedraw()
+        struct redraw_state {
+            int frame = -1;
+            int knobs = 0;
+            bool needs_redraw = false;
+            int hovered = 0;// 1 + index of the hovered knob within the frame, 0 if none
+            int previous_hovered = 0;
+        };
+
+        static redraw_state redraw;
+
+        // Records the knob that was just drawn, which must be the last item
+        static void note_redraw(bool value_changed) {
+            auto frame = ImGui::GetFrameCount();
+            if (redraw.frame != frame) {
+                redraw.previous_hovered = redraw.frame == frame - 1 ? redraw.hovered : 0;
+                redraw.frame = frame;
+                redraw.knobs = 0;
+                redraw.needs_redraw = false;
+                redraw.hovered = 0;
+            }
+
+            redraw.knobs++;
+            if (value_changed || ImGui::IsItemActive() || ImGui::IsItemDeactivated()) {
+                redraw.needs_redraw = true;
+            }
+            if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByActiveItem)) {
+                redraw.hovered = redraw.knobs;
+            }
+        }
+
+        static float knob_width(float size) {
+#if IMGUI_VERSION_NUM < 19197
+            auto font_scale = ImGui::GetIO().FontGlobalScale;
+#else
+            auto font_scale = ImGui::GetStyle().FontScaleMain;
+#endif
+            return size == 0 ? ImGui::GetTextLineHeight() * 4.0f : size * font_scale;
+        }
+
+        enum format_kind_ {
+            format_kind_printf,// Anything not handled below
+            format_kind_float, // prefix %f or %.Nf (N <= 7) suffix
+            format_kind_int,   // prefix %d or %i suffix
+        };
+
+        // A format string parsed into the parts the fast formatter needs. Formats it covers are copied into
+        // `text`, which holds the prefix and suffix and tells whether the string at `format` was rewritten.
+        struct format_spec {
+            const char *format;
+            int kind;
+            int precision;
+            int prefix_length;
+            int suffix_length;
+            int length;
+            char text[32];
+        };
+
+        static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7};
+
+        static void parse_format(format_spec &spec, const char *format) {
+            spec.format = format;
+            spec.kind = format_kind_printf;
+
+            // A single conversion without flags or width, and no other '%' in the prefix or suffix
+            auto *conversion = strchr(format, '%');
+            if (!conversion) {
+                return;
+            }
+            auto *c = conversion + 1;
+            auto precision = 6;
+            if (*c == '.') {
+                c++;
+                if (*c < '0' || *c > '7' || (c[1] >= '0' && c[1] <= '9')) {
+                    return;
+                }
+                precision = *c++ - '0';
+                if (*c != 'f') {
+                    return;
+                }
+            }
+            if (strchr(c + 1, '%')) {
+                return;
+            }
+
+            auto length = (int) strlen(format);
+            if (length >= IM_ARRAYSIZE(spec.text)) {
+                return;
+            }
+            if (*c == 'f') {
+                spec.kind = format_kind_float;
+            } else if ((*c == 'd' || *c == 'i') && c == conversion + 1) {
+                spec.kind = format_kind_int;
+            } else {
+                return;
+            }
+            spec.precision = precision;
+            spec.prefix_length = (int) (conversion - format);
+            spec.suffix_length = (int) (format + length - (c + 1));
+            spec.length = length;
+            memcpy(spec.text, format, length + 1);
+        }
+
+        // Format strings are usually literals, so the parsed form is looked up by address. A format the fast
+        // path covers is also compared with its copy, in case the address is a buffer that was rewritten; any
+        // other format goes to printf, which is right whatever the string now holds.
+        static const format_spec &compiled_format(const char *format) {
+            static format_spec specs[64];
+            auto &spec = specs[((size_t) format >> 3) % IM_ARRAYSIZE(specs)];
+            if (spec.format != format || (spec.kind != format_kind_printf && strcmp(spec.text, format) != 0)) {
+                parse_format(spec, format);
+            }
+            return spec;
+        }
+
+        // Writes the decimal digits of `value` backwards, ending at `end`, and returns the first digit
+        static char *write_digits(char *end, ImU64 value, int min_digits) {
+            auto *p = end;
+            do {
+                *--p = (char) ('0' + value % 10);
+                value /= 10;
+                min_digits--;
+            } while (value != 0 || min_digits > 0);
+            return p;
+        }
+
+        // Formats the value of `spec` into `buf`. Returns -1 when the value is not covered and printf must be used.
+        static int format_spec_value(char *buf, int buf_size, const format_spec &spec, ImGuiDataType data_type, const void *p_data) {
+            ImU64 integer;
+            ImU64 fraction = 0;
+            bool negative;
+            if (spec.kind == format_kind_float && data_type == ImGuiDataType_Float) {
+                // float * 10^p needs at most 24 + 17 significant bits, so the product is exact in a double and
+                // rounding it to an integer rounds the exact value, ties to even, like printf does
+                auto v = *(const float *) p_data;
+                auto scaled = (double) v * powers_of_ten[spec.precision];
+                if (!(ImAbs(scaled) < 9007199254740992.0)) {
+                    return -1;// Too large, infinite or NaN
+                }
+                auto rounded = (ImU64) ImAbs(nearbyint(scaled));
+                auto unit = (ImU64) powers_of_ten[spec.precision];
+                negative = signbit(v) != 0;
+                integer = rounded / unit;
+                fraction = rounded % unit;
+            } else if (spec.kind == format_kind_int && data_type == ImGuiDataType_S32) {
+                auto v = *(const ImS32 *) p_data;
+                negative = v < 0;
+                integer = negative ? (ImU64) (-(ImS64) v) : (ImU64) v;
+            } else {
+                return -1;
+            }
+
+            char digits[32];
+            auto *end = digits + IM_ARRAYSIZE(digits);
+            auto *start = end;
+            if (spec.kind == format_kind_float && spec.precision > 0) {
+                start = write_digits(start, fraction, spec.precision);
+                *--start = '.';
+            }
+            start = write_digits(start, integer, 1);
+            if (negative) {
+                *--start = '-';
+            }
+
+            auto digits_length = (int) (end - start);
+            auto length = spec.prefix_length + digits_length + spec.suffix_length;
+            if (length >= buf_size) {
+                return -1;
+            }
+            memcpy(buf, spec.text, spec.prefix_length);
+            memcpy(buf + spec.prefix_length, start, digits_length);
+            memcpy(buf + spec.prefix_length + digits_length, spec.text + spec.length - spec.suffix_length, spec.suffix_length);
+            buf[length] = 0;
+            return length;
+        }
+
+        // Formatted value of a knob, reused until the value or the format changes. The format is compared by
+        // contents, as it may be a buffer rewritten in place.
+        struct value_text {
+            ImU64 value_bits;
+            ImGuiID format_hash = 0;
+            ImGuiDataType data_type = -1;
+            bool live = true;// The input was hovered, active or focused on its last frame
+            int length = 0;
+            char text[64];
+        };
+
+        static ImPool<value_text> value_texts;
+
+        // Entries of knobs that are no longer drawn are dropped when the cache fills up
+        static const int value_text_cache_capacity = 1 << 16;
+
+        static value_text *find_value_text(ImGuiID id) {
+            auto *entry = value_texts.GetByKey(id);
+            if (!entry) {
+                if (value_texts.GetAliveCount() >= value_text_cache_capacity) {
+                    value_texts.Clear();
+                }
+                entry = value_texts.GetOrAddByKey(id);
+            }
+            return entry;
+        }
+
+        static ImGuiID hash_format(const char *format) {
+            return ImHashData(format, strlen(format));
+        }
+
+        // Returns the value formatted like DragScalar() does, from `entry`. `format_hash` is hash_format(format).
+        template<typename DataType>
+        static const char *format_value(value_text *entry, ImGuiDataType data_type, const DataType *p_value, const char *format, ImGuiID format_hash, const char **text_end) {
+            ImU64 value_bits = 0;
+            memcpy(&value_bits, p_value, sizeof(DataType));
+
+            if (entry->format_hash != format_hash || entry->data_type != data_type || entry->value_bits != value_bits) {
+                entry->value_bits = value_bits;
+                entry->format_hash = format_hash;
+                entry->data_type = data_type;
+                entry->length = FormatValue(entry->text, IM_ARRAYSIZE(entry->text), data_type, p_value, format);
+            }
+            *text_end = entry->text + entry->length;
+            return entry->text;
+        }
+
+        // DragScalar("###knob_drag") in the ID scope of the knob, whose ID is `id`. While the input is idle (it was
+        // neither hovered, active nor focused on its last frame, and neither the mouse nor the keyboard focus is on
+        // it now) only what DragScalar() draws for it is drawn: the frame and the cached value text, as an item of
+        // the same ID that can be tabbed to. Older Dear ImGui versions cannot add such an item and always get
+        // DragScalar().
+        template<typename DataType>
+        static bool value_input(ImGuiID id, ImGuiDataType data_type, DataType *p_value, float speed, DataType v_min, DataType v_max, const char *format, ImGuiID format_hash, ImGuiSliderFlags flags) {
+            auto *entry = find_value_text(id);
+#if IMGUI_VERSION_NUM >= 18413
+            auto *window = ImGui::GetCurrentWindow();
+            if (window->SkipItems) {
+                return false;
+            }
+
+            const auto &style = ImGui::GetStyle();
+            auto pos = window->DC.CursorPos;
+            ImRect frame_bb(pos, {pos.x + ImGui::CalcItemWidth(), pos.y + ImGui::GetFrameHeight()});
+            if (!entry->live && ImGui::GetActiveID() != id && ImGui::GetFocusID() != id && !ImGui::IsMouseHoveringRect(frame_bb.Min, frame_bb.Max)) {
+                ImGui::ItemSize(frame_bb, style.FramePadding.y);
+                if (!ImGui::ItemAdd(frame_bb, id, &frame_bb, ImGuiItemFlags_Inputable)) {
+                    return false;
+                }
+                entry->live = ImGui::IsItemFocused();
+
+                ImGui::RenderFrame(frame_bb.Min, frame_bb.Max, ImGui::GetColorU32(ImGuiCol_FrameBg), true, style.FrameRounding);
+                const char *text_end;
+                auto *text = format_value(entry, data_type, p_value, format, format_hash, &text_end);
+                ImGui::RenderTextClipped(frame_bb.Min, frame_bb.Max, text, text_end, NULL, ImVec2(0.5f, 0.5f));
+                return false;
+            }
+#endif
+
+            auto changed = ImGui::DragScalar("###knob_drag", data_type, p_value, speed, &v_min, &v_max, format, flags);
+            entry->live = ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByActiveItem) || ImGui::IsItemActive() || ImGui::IsItemFocused();
+            return changed;
+        }
+
+        // Measured size of a title, keyed on the label and everything its measurement depends on
+        struct title_metrics {
+            float centering_width;// Wrapped at the knob width, used to center the title
+            ImVec2 size;          // Unwrapped, as ImGui::Text() lays it out
+        };
+
+        static ImPool<title_metrics> title_metrics_cache;
+
+        // Entries of fonts or sizes that are no longer used are never hit again, and are dropped when the
+        // cache fills up
+        static const int title_metrics_cache_capacity = 1 << 16;
+
+        // Identifies what the glyph advances of `font` were built from. A rebuilt atlas may reuse the address of a
+        // font, and many backends keep its texture ID, so the font's own metrics are hashed as well.
+        static ImGuiID font_fingerprint(const ImFont *font) {
+#if IMGUI_VERSION_NUM < 19197
+            struct {
+                const ImFont *font;
+                float font_size;
+                float ascent;
+                float descent;
+                float fallback_advance_x;
+                int glyph_count;
+                int index_count;
+            } data;
+            memset(&data, 0, sizeof(data));
+            data.font = font;
+            data.font_size = font->FontSize;
+            data.ascent = font->Ascent;
+            data.descent = font->Descent;
+            data.fallback_advance_x = font->FallbackAdvanceX;
+            data.glyph_count = font->Glyphs.Size;
+            data.index_count = font->IndexAdvanceX.Size;
+            // The advances of ASCII, which tell apart fonts of the same size and ranges
+            auto seed = ImHashData(&data, sizeof(data));
+            return ImHashData(font->IndexAdvanceX.Data, sizeof(float) * ImMin(font->IndexAdvanceX.Size, 128), seed);
+#else
+            // Fonts get a new ID when added to the atlas, and merged fonts a new source
+            struct {
+                const ImFont *font;
+                ImGuiID font_id;
+                int source_count;
+            } data;
+            memset(&data, 0, sizeof(data));
+            data.font = font;
+            data.font_id = font->FontId;
+            data.source_count = font->Sources.Size;
+            return ImHashData(&data, sizeof(data));
+#endif
+        }
+
+        // Fingerprint of the last font titles were drawn with, computed once per frame and context, and the seed of
+        // the keys of the titles of its size and width
+        static struct {
+            const ImGuiContext *context;
+            int frame;
+            const ImFont *font;
+            ImGuiID fingerprint;
+            float font_size;
+            float width;
+            ImGuiID seed;
+        } title_font = {NULL, -1, NULL, 0, 0.0f, 0.0f, 0};
+
+        static const title_metrics &get_title_metrics(const char *label, const char *label_end, float width) {
+            const auto &g = *GImGui;
+            if (title_font.context != &g || title_font.frame != g.FrameCount || title_font.font != g.Font) {
+                title_font.context = &g;
+                title_font.frame = g.FrameCount;
+                title_font.font = g.Font;
+                title_font.fingerprint = font_fingerprint(g.Font);
+                title_font.width = -1.0f;
+            }
+            if (title_font.font_size != g.FontSize || title_font.width != width) {
+                struct {
+                    ImGuiID font;
+                    float font_size;
+                    float width;
+                } key_data;
+                memset(&key_data, 0, sizeof(key_data));
+                key_data.font = title_font.fingerprint;
+                key_data.font_size = g.FontSize;
+                key_data.width = width;
+                title_font.font_size = g.FontSize;
+                title_font.width = width;
+                title_font.seed = ImHashData(&key_data, sizeof(key_data));
+            }
+            auto key = ImHashStr(label, label_end - label, title_font.seed);
+
+            if (auto *metrics = title_metrics_cache.GetByKey(key)) {
+                return *metrics;
+            }
+            if (title_metrics_cache.GetAliveCount() >= title_metrics_cache_capacity) {
+                title_metrics_cache.Clear();
+            }
+            auto *metrics = title_metrics_cache.GetOrAddByKey(key);
+            metrics->centering_width = ImGui::CalcTextSize(label, label_end, false, width).x;
+            metrics->size = ImGui::CalcTextSize(label, label_end);
+            return *metrics;
+        }
+
+        // Centered ImGui::Text("%s", label), measured through the cache
+        static void draw_title(const char *label, float width) {
+            auto *window = ImGui::GetCurrentWindow();
+            auto *label_end = label + strlen(label);
+
+            // Wrapped and long text take paths of ImGui::TextEx() that are not reproduced here
+            if (window->DC.TextWrapPos >= 0.0f || label_end - label > 2000) {
+                auto title_size = ImGui::CalcTextSize(label, label_end, false, width);
+                ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - title_size[0]) * 0.5f);
+                ImGui::TextUnformatted(label, label_end);
+                return;
+            }
+
+            const auto &metrics = get_title_metrics(label, label_end, width);
+            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + (width - metrics.centering_width) * 0.5f);
+
+            ImVec2 pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+            ImRect bb(pos, {pos.x + metrics.size.x, pos.y + metrics.size.y});
+            ImGui::ItemSize(metrics.size, 0.0f);
+            if (!ImGui::ItemAdd(bb, 0)) {
+                return;
+            }
+            ImGui::RenderTextWrapped(bb.Min, label, label_end, 0.0f);
+        }
+
+        // The caches above are shared by all contexts, as nothing in them depends on one. They are freed when any
+        // context is destroyed, so none of their memory outlives the last one; the others rebuild what they use.
+        static ImGuiContext *hooked_context = NULL;
+
+        static void free_caches(ImGuiContext *, ImGuiContextHook *) {
+            clear_meshes();
+            path_list._ClearFreeMemory();
+            tick_tables.Clear();
+            value_texts.Clear();
+            title_metrics_cache.Clear();
+            title_font.context = NULL;
+            hooked_context = NULL;
+        }
+
+        // Adds the hook freeing the caches on shutdown to the current context, unless it already has it
+        static void hook_context() {
+            auto &g = *GImGui;
+            if (hooked_context == &g) {
+                return;
+            }
+            hooked_context = &g;
+            for (const auto &hook: g.Hooks) {
+                if (hook.Callback == free_caches) {
+                    return;
+                }
+            }
+            ImGuiContextHook hook;
+            hook.Type = ImGuiContextHookType_Shutdown;
+            hook.Callback = free_caches;
+            ImGui::AddContextHook(&g, &hook);
+        }
+
+        // Title, knob, tooltip and input of a single knob. The caller pushes `handle.scope_id` as the ID scope, and
+        // the item width, and passes hash_format(format).
+        template<typename DataType>
+        knob<DataType> knob_item(
+                const KnobHandle &handle,
+                const char *label,
+                ImGuiDataType data_type,
+                DataType *p_value,
+                DataType v_min,
+                DataType v_max,
+                float _speed,
+                const char *format,
+                ImGuiID format_hash,
+                float width,
+                ImGuiKnobFlags flags,
+                float angle_min,
+                float angle_max) {
+            if (flags & ImGuiKnobFlags_Logarithmic && v_min <= 0.0 && v_max >= 0.0) {
+                // we must handle the cornercase if a client specifies a logarithmic range that contains zero
+                // for this we clamp lower limit to avoid hitting zero like it is done in ImGui::SliderBehaviorT
+                const bool is_floating_point = (data_type == ImGuiDataType_Float) || (data_type == ImGuiDataType_Double);
+                const int decimal_precision = is_floating_point ? ImParseFormatPrecision(format, 3) : 1;
+                v_min = ImPow(0.1f, (float) decimal_precision);
+                v_max = ImMax(v_min, v_max); // this ensures that in the cornercase v_max is still at least ge v_min
+                *p_value = ImMax(ImMin(*p_value, v_max), v_min); // this ensures that in the cornercase p_value is within the range
+            }
+
+            auto speed = _speed == 0 ? (v_max - v_min) / 250.f : _speed;
+
+            hook_context();
+            ImGui::BeginGroup();
+
+            // There's an issue with `SameLine` and Groups, see
+            // https://github.com/ocornut/imgui/issues/4190. This is probably not the best
+            // solution, but seems to work for now
+            ImGui::GetCurrentWindow()->DC.CurrLineTextBaseOffset = 0;
+
+            // Draw title
+            if (!(flags & ImGuiKnobFlags_NoTitle) && !ImGui::GetCurrentWindow()->SkipItems) {
+                draw_title(label, width);
+            }
+
+            // Draw knob
+            knob<DataType> k(handle.button_id, data_type, p_value, v_min, v_max, speed, width * 0.5f, format, flags, angle_min, angle_max);
+
+            // Draw tooltip
+            if (flags & ImGuiKnobFlags_ValueTooltip &&
+                (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled) ||
+                 ImGui::IsItemActive())) {
+                const char *text_end;
+                auto *text = format_value(find_value_text(handle.input_id), data_type, p_value, format, format_hash, &text_end);
+                ImGui::BeginTooltip();
+                ImGui::TextUnformatted(text, text_end);
+                ImGui::EndTooltip();
+            }
+
+            // Draw input
+            if (!(flags & ImGuiKnobFlags_NoInput)) {
+                ImGuiSliderFlags drag_scalar_flags = 0;
+                if (flags & ImGuiKnobFlags_AlwaysClamp) {
+                    drag_scalar_flags |= ImGuiSliderFlags_AlwaysClamp;
+                }
+                if (flags & ImGuiKnobFlags_Logarithmic) {
+                    drag_scalar_flags |= ImGuiSliderFlags_Logarithmic;
+                }
+                auto changed = value_input(handle.input_id, data_type, p_value, speed, v_min, v_max, format, format_hash, drag_scalar_flags);
+                if (changed) {
+                    k.value_changed = true;
+                }
+            }
+
+            ImGui::EndGroup();
+            note_redraw(k.value_changed);
+
+            return k;
+        }
+
+        static bool has_next_modulation = false;
+        static float next_modulation = 0.0f;
+        static const float *next_bank_modulation = NULL;
+
+        static EventQueue *event_queue = NULL;
+        static bool has_next_param = false;
+        static ImGuiID next_param_id = 0;
+
+        // Events the queue was full for, at most one per param_id, pushed before any newer event
+        static ImVector<Event> pending_events;
+
+        // Folds `event` into `pending`, an older event of the same param that is still waiting. A gesture that
+        // ended while the next one began is reported as one longer gesture.
+        static void merge_event(Event &pending, const Event &event) {
+            auto flags = event.flags;
+            if ((pending.flags & ImGuiKnobEventFlags_GestureEnd) && (flags & ImGuiKnobEventFlags_GestureBegin)) {
+                pending.flags &= ~ImGuiKnobEventFlags_GestureEnd;
+                flags &= ~ImGuiKnobEventFlags_GestureBegin;
+            }
+            pending.flags |= flags;
+            pending.value = event.value;
+            pending.time = event.time;
+        }
+
+        // Pushes the waiting events that fit in the queue, oldest first
+        static void push_pending_events() {
+            int pushed = 0;
+            while (pushed < pending_events.Size && event_queue->Push(pending_events[pushed])) {
+                pushed++;
+            }
+            if (pushed > 0) {
+                pending_events.erase(pending_events.begin(), pending_events.begin() + pushed);
+            }
+        }
+
+        // Pushes the event of the knob that was just drawn, which must be the last item. Events that do not fit
+        // are kept and pushed again by the next knob, so that no gesture is left without its end. `default_param`
+        // tells that `param_id` is the ImGui ID of the knob rather than one given by SetNextKnobParam().
+        static void push_knob_event(ImGuiID param_id, bool default_param, float value, bool value_changed) {
+            if (pending_events.Size > 0) {
+                push_pending_events();
+            }
+
+            ImGuiKnobEventFlags flags = 0;
+            if (ImGui::IsItemActivated()) {
+                flags |= ImGuiKnobEventFlags_GestureBegin;
+            }
+            if (value_changed) {
+                flags |= ImGuiKnobEventFlags_ValueChanged;
+            }
+            if (ImGui::IsItemDeactivated()) {
+                flags |= ImGuiKnobEventFlags_GestureEnd;
+            }
+            if (flags == 0) {
+                return;
+            }
+            if (default_param) {
+                flags |= ImGuiKnobEventFlags_DefaultParam;
+            }
+
+            Event event;
+            event.param_id = param_id;
+            event.flags = flags;
+            event.value = value;
+            event.time = ImGui::GetTime();
+            if (pending_events.Size == 0 && event_queue->Push(event)) {
+                return;
+            }
+            for (auto &pending: pending_events) {
+                if (pending.param_id == param_id && (pending.flags & ImGuiKnobEventFlags_DefaultParam) == (flags & ImGuiKnobEventFlags_DefaultParam)) {
+                    merge_event(pending, event);
+                    return;
+                }
+            }
+            pending_events.push_back(event);
+        }
+
+        template<typename DataType>
+        knob<DataType> knob_with_drag(
+                const KnobHandle &handle,
+                const char *label,
+                ImGuiDataType data_type,
+                DataType *p_value,
+                DataType v_min,
+                DataType v_max,
+                float speed,
+                const char *format,
+                float size,
+                ImGuiKnobFlags flags,
+                float angle_min,
+                float angle_max) {
+            ImGui::PushOverrideID(handle.scope_id);
+            auto width = knob_width(size);
+            ImGui::PushItemWidth(width);
+
+            auto k = knob_item(handle, label, data_type, p_value, v_min, v_max, speed, format, hash_format(format), width, flags, angle_min, angle_max);
+            if (event_queue) {
+                auto param_id = has_next_param ? next_param_id : k.id;
+                push_knob_event(param_id, !has_next_param, (float) *p_value, k.value_changed);
+            }
+            has_next_param = false;
+            if (has_next_modulation && k.is_visible) {
+                k.set_modulation(next_modulation);
+            }
+            has_next_modulation = false;
+
+            ImGui::PopItemWidth();
+            ImGui::PopID();
+
+            return k;
+        }
+
+        // Level of detail: small knobs may drop anti-aliasing and simplify their variant
+        struct knob_lod {
+            ImDrawListFlags draw_list_flags;
+            bool simplified;
+        };
+
+        static knob_lod lod_for_radius(const ImDrawList *draw_list, float radius) {
+            const auto &config = GetConfig();
+            knob_lod lod;
+            lod.draw_list_flags = draw_list->Flags;
+            if (radius < config.lod_no_aa_radius) {
+                lod.draw_list_flags &= ~(ImDrawListFlags_AntiAliasedFill | ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedLinesUseTex);
+            }
+            lod.simplified = radius < config.lod_simplify_radius;
+            return lod;
+        }
+
+        // Draws `knob` as `Variant`, with its background from `background`, which knobs of the same size may share
+        template<ImGuiKnobVariant Variant, typename DataType>
+        void draw_variant(knob<DataType> &knob, int steps, const palette &colors, const knob_lod &lod, background_source &background) {
+            auto *draw_list = ImGui::GetWindowDrawList();
+            auto draw_list_flags = draw_list->Flags;
+            draw_list->Flags = lod.draw_list_flags;
+
+            auto has_background = knob.draw_background(Variant, steps, background);
+            recipe<Variant>::draw(knob, steps, colors, has_background, lod.simplified);
+
+            draw_list->Flags = draw_list_flags;
+        }
+
+        template<typename DataType>
+        void draw_knob(knob<DataType> &knob, ImGuiKnobVariant variant, int steps, const palette &colors, const knob_lod &lod, background_source &background) {
+            switch (variant) {
+                case ImGuiKnobVariant_Tick:
+                    draw_variant<ImGuiKnobVariant_Tick>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_Dot:
+                    draw_variant<ImGuiKnobVariant_Dot>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_Wiper:
+                    draw_variant<ImGuiKnobVariant_Wiper>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_WiperOnly:
+                    draw_variant<ImGuiKnobVariant_WiperOnly>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_WiperDot:
+                    draw_variant<ImGuiKnobVariant_WiperDot>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_Stepped:
+                    draw_variant<ImGuiKnobVariant_Stepped>(knob, steps, colors, lod, background);
+                    break;
+                case ImGuiKnobVariant_Space:
+                    draw_variant<ImGuiKnobVariant_Space>(knob, steps, colors, lod, background);
+                    break;
+            }
+        }
+
+        // Runs the layers of `skin`, starting after the static ones when they were drawn from the mesh cache
+        template<typename DataType>
+        void draw_skin(knob<DataType> &knob, const Skin &skin, int steps, const palette &colors, const knob_lod &lod) {
+            auto *draw_list = ImGui::GetWindowDrawList();
+            auto draw_list_flags = draw_list->Flags;
+            draw_list->Flags = lod.draw_list_flags;
+
+            const ImU32 *roles[ImGuiKnobSkinColor_COUNT] = {colors.primary, colors.secondary, colors.track, colors.modulation};
+            auto first = knob.draw_skin_background(skin, steps) ? skin.StaticCount : 0;
+            for (int i = first; i < skin.Commands.Size; i++) {
+                const auto &command = skin.Commands[i];
+                const auto *role = roles[command.color];
+                switch (command.layer) {
+                    case ImGuiKnobSkinLayer_Circle:
+                        knob.draw_circle(command.a, role);
+                        break;
+                    case ImGuiKnobSkinLayer_Track:
+                        knob.draw_arc(command.a, command.b, knob.angle_min, knob.angle_max, role);
+                        break;
+                    case ImGuiKnobSkinLayer_Value:
+                        if (knob.t > 0.01f) {
+                            knob.draw_arc(command.a, command.b, knob.angle_min, knob.angle, role);
+                        }
+                        break;
+                    case ImGuiKnobSkinLayer_Modulation:
+                        knob.draw_modulation(command.a, command.b, role);
+                        break;
+                    case ImGuiKnobSkinLayer_Ticks:
+                        for (const auto &direction: tick_directions(steps, knob.angle_min, knob.angle_max)) {
+                            knob.draw_tick(command.a, command.b, command.c, direction, role);
+                        }
+                        break;
+                    case ImGuiKnobSkinLayer_Tick:
+                        knob.draw_tick(command.a, command.b, command.c, {knob.angle_cos, knob.angle_sin}, role);
+                        break;
+                    case ImGuiKnobSkinLayer_Dot:
+                        knob.draw_dot(command.b, command.a, knob.angle, role);
+                        break;
+                }
+            }
+
+            draw_list->Flags = draw_list_flags;
+        }
+
+        // How BaseKnob() draws a knob: a variant, a skin, or a filmstrip
+        struct variant_drawer {
+            ImGuiKnobVariant variant;
+            int steps;
+
+            template<typename DataType>
+            void draw(knob<DataType> &knob, const palette &colors, const knob_lod &lod) const {
+                background_source background;
+                draw_knob(knob, variant, steps, colors, lod, background);
+            }
+        };
+
+        struct skin_drawer {
+            const Skin &skin;
+            int steps;
+
+            template<typename DataType>
+            void draw(knob<DataType> &knob, const palette &colors, const knob_lod &lod) const {
+                draw_skin(knob, skin, steps, colors, lod);
+            }
+        };
+
+        struct filmstrip_drawer {
+            const Filmstrip &filmstrip;
+
+            template<typename DataType>
+            void draw(knob<DataType> &knob, const palette &, const knob_lod &) const {
+                IM_ASSERT(filmstrip.FrameCount > 0 && filmstrip.Columns > 0);
+                // t is NaN for an empty range or a NaN value, which must not reach the int conversion
+                auto t = knob.t == knob.t ? ImSaturate(knob.t) : 0.0f;
+                auto frame = ImClamp((int) (t * (float) (filmstrip.FrameCount - 1) + 0.5f), 0, filmstrip.FrameCount - 1);
+                auto rows = (filmstrip.FrameCount + filmstrip.Columns - 1) / filmstrip.Columns;
+                auto frame_width = (filmstrip.UVMax.x - filmstrip.UVMin.x) / (float) filmstrip.Columns;
+                auto frame_height = (filmstrip.UVMax.y - filmstrip.UVMin.y) / (float) rows;
+                ImVec2 uv_min(filmstrip.UVMin.x + frame_width * (float) (frame % filmstrip.Columns),
+                              filmstrip.UVMin.y + frame_height * (float) (frame / filmstrip.Columns));
+                ImVec2 uv_max(uv_min.x + frame_width, uv_min.y + frame_height);
+
+                auto *draw_list = ImGui::GetWindowDrawList();
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_scope scope(StatsPrimitive_Circle, draw_list);
+#endif
+                draw_list->AddImage(
+                        filmstrip.TextureID,
+                        {knob.center.x - knob.radius, knob.center.y - knob.radius},
+                        {knob.center.x + knob.radius, knob.center.y + knob.radius},
+                        uv_min,
+                        uv_max);
+            }
+        };
+
+        // Shared state of KnobBank and KnobGrid. Everything that only depends on the shared parameters is
+        // resolved once for all knobs; the ID scope and item width are pushed until end().
+        template<typename DataType>
+        struct bank {
+            ImGuiDataType data_type;
+            DataType *values;
+            const DataType *mins;
+            const DataType *maxes;
+            const char *const *labels;
+            float speed;
+            const char *format;
+            ImGuiID format_hash;
+            ImGuiKnobVariant variant;
+            ImGuiKnobFlags flags;
+            int steps;
+            float angle_min;
+            float angle_max;
+            float width;
+            const palette &colors;
+            knob_lod lod;
+            background_source background;// Resolved by the first visible knob
+            int *changed;
+            int changed_count;
+            bool has_param;
+            ImGuiID param_id;
+            const float *modulation;
+
+            bank(const char *str_id,
+                 ImGuiDataType data_type,
+                 DataType *values,
+                 const DataType *mins,
+                 const DataType *maxes,
+                 const char *const *labels,
+                 float speed,
+                 const char *format,
+                 ImGuiKnobVariant variant,
+                 float size,
+                 ImGuiKnobFlags flags,
+                 int steps,
+                 float angle_min,
+                 float angle_max,
+                 int *changed)
+                : data_type(data_type), values(values), mins(mins), maxes(maxes), labels(labels), speed(speed),
+                  format(format), format_hash(hash_format(format)), variant(variant), flags(flags), steps(steps), angle_min(angle_min),
+                  angle_max(angle_max), width(knob_width(size)), colors(GetPalette()),
+                  lod(lod_for_radius(ImGui::GetWindowDrawList(), width * 0.5f)), changed(changed), changed_count(0),
+                  has_param(has_next_param), param_id(next_param_id), modulation(next_bank_modulation) {
+                has_next_param = false;
+                next_bank_modulation = NULL;
+                ImGui::PushID(str_id);
+                ImGui::PushItemWidth(width);
+            }
+
+            // Draws knob `i` and returns whether it (or its input) is active
+            bool draw(int i) {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+                stats_begin_knob(variant);
+#endif
+                // The ID scope comes from the index, so knobs may share labels
+                KnobHandle handle(ImGui::GetID(i), labels[i]);
+                ImGui::PushOverrideID(handle.scope_id);
+                auto k = knob_item(handle, labels[i], data_type, &values[i], mins[i], maxes[i], speed, format, format_hash, width, flags, angle_min, angle_max);
+                if (event_queue) {
+                    push_knob_event(has_param ? param_id + (ImGuiID) i : k.id, !has_param, (float) values[i], k.value_changed);
+                }
+                if (k.is_visible) {
+                    // Only the modulation of visible knobs is read
+                    if (modulation) {
+                        k.set_modulation(modulation[i]);
+                    }
+                    draw_knob(k, variant, steps, colors, lod, background);
+                }
+                ImGui::PopID();
+
+                if (k.value_changed) {
+                    if (changed) {
+                        changed[changed_count] = i;
+                    }
+                    changed_count++;
+                }
+
+                // The group of the knob is the last item, and is active while any of its items is
+                return ImGui::IsItemActive();
+            }
+
+            int end() {
+                ImGui::PopItemWidth();
+                ImGui::PopID();
+                return changed_count;
+            }
+        };
+
+    }// namespace detail
+
+    KnobHandle::KnobHandle(ImGuiID scope_id) : KnobHandle(scope_id, "###knob") {}
+
+    KnobHandle::KnobHandle(ImGuiID scope_id, const char *label)
+        : scope_id(scope_id), button_id(ImHashStr(label, 0, scope_id)), input_id(ImHashStr("###knob_drag", 0, scope_id)) {}
+
+    KnobHandle::KnobHandle(const char *label) : KnobHandle(ImGui::GetID(label), label) {}
+
+    template<typename DataType, typename Drawer>
+    bool BaseKnob(
+            const KnobHandle &handle,
+            const char *label,
+            ImGuiDataType data_type,
+            DataType *p_value,
+            DataType v_min,
+            DataType v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            float angle_min,
+            float angle_max,
+            const Drawer &drawer) {
+#ifdef IMGUIKNOBS_ENABLE_STATS
+        detail::stats_begin_knob(variant);
+#else
+        IM_UNUSED(variant);
+#endif
+        auto knob = detail::knob_with_drag(
+                handle,
+                label,
+                data_type,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                size,
+                flags,
+                angle_min,
+                angle_max);
+
+        if (!knob.is_visible) {
+            return knob.value_changed;
+        }
+
+        auto *draw_list = ImGui::GetWindowDrawList();
+        drawer.draw(knob, detail::GetPalette(), detail::lod_for_radius(draw_list, knob.radius));
+
+        return knob.value_changed;
+    }
+
+    bool Knob(
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        return BaseKnob(
+                KnobHandle(label),
+                label,
+                ImGuiDataType_Float,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                angle_min,
+                angle_max,
+                detail::variant_drawer{variant, steps});
+    }
+
+    bool Knob(
+            const KnobHandle &handle,
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        return BaseKnob(
+                handle,
+                label,
+                ImGuiDataType_Float,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                angle_min,
+                angle_max,
+                detail::variant_drawer{variant, steps});
+    }
+
+    bool KnobInt(
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        return BaseKnob(
+                KnobHandle(label),
+                label,
+                ImGuiDataType_S32,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                angle_min,
+                angle_max,
+                detail::variant_drawer{variant, steps});
+    }
+
+    bool KnobInt(
+            const KnobHandle &handle,
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        return BaseKnob(
+                handle,
+                label,
+                ImGuiDataType_S32,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                angle_min,
+                angle_max,
+                detail::variant_drawer{variant, steps});
+    }
+
+    Skin &Skin::Add(ImGuiKnobSkinLayer layer, ImGuiKnobSkinColor color, float a, float b, float c) {
+        IM_ASSERT(layer >= ImGuiKnobSkinLayer_Circle && layer <= ImGuiKnobSkinLayer_Dot);
+        IM_ASSERT(color >= 0 && color < ImGuiKnobSkinColor_COUNT);
+        SkinCommand command;
+        command.layer = layer;
+        command.color = color;
+        command.a = a;
+        command.b = b;
+        command.c = c;
+        if (StaticCount == Commands.Size && detail::skin_layer_is_static(layer)) {
+            StaticCount++;
+        }
+        Commands.push_back(command);
+        ID = ImHashData(&command, sizeof(command), ID);
+        return *this;
+    }
+
+    bool Skin::Parse(const char *text) {
+        Commands.clear();
+        StaticCount = 0;
+        ID = 0;
+
+        for (auto *line = text; *line;) {
+            auto *line_end = line;
+            while (*line_end && *line_end != '\n' && *line_end != ';') {
+                line_end++;
+            }
+            auto *content_end = line;
+            while (content_end < line_end && *content_end != '#') {
+                content_end++;
+            }
+            if (!detail::parse_skin_layer(*this, line, content_end)) {
+                Commands.clear();
+                StaticCount = 0;
+                ID = 0;
+                return false;
+            }
+            line = *line_end ? line_end + 1 : line_end;
+        }
+        return true;
+    }
+
+    bool Knob(
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            const Skin &skin,
+            float speed,
+            const char *format,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        return BaseKnob(
+                KnobHandle(label),
+                label,
+                ImGuiDataType_Float,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                0,
+                size,
+                flags,
+                angle_min,
+                angle_max,
+                detail::skin_drawer{skin, steps});
+    }
+
+    bool KnobInt(
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            const Skin &skin,
             float speed,
             const char *format,
-            ImGuiKnobVariant variant,
             float size,
             ImGuiKnobFlags flags,
             int steps,
             float angle_min,
             float angle_max) {
-        auto knob = detail::knob_with_drag(
+        return BaseKnob(
+                KnobHandle(label),
                 label,
-                data_type,
+                ImGuiDataType_S32,
                 p_value,
                 v_min,
                 v_max,
                 speed,
                 format,
+                0,
                 size,
                 flags,
                 angle_min,
-                angle_max);
-
-        switch (variant) {
-            case ImGuiKnobVariant_Tick: {
-                knob.draw_circle(0.85f, detail::GetSecondaryColorSet(), true, 32);
-                knob.draw_tick(0.5f, 0.85f, 0.08f, knob.angle, detail::GetPrimaryColorSet());
-                break;
-            }
-            case ImGuiKnobVariant_Dot: {
-                knob.draw_circle(0.85f, detail::GetSecondaryColorSet(), true, 32);
-                knob.draw_dot(0.12f, 0.6f, knob.angle, detail::GetPrimaryColorSet(), true, 12);
-                break;
-            }
-
-            case ImGuiKnobVariant_Wiper: {
-                knob.draw_circle(0.7f, detail::GetSecondaryColorSet(), true, 32);
-                knob.draw_arc(0.8f, 0.41f, knob.angle_min, knob.angle_max, detail::GetTrackColorSet());
-
-                if (knob.t > 0.01f) {
-                    knob.draw_arc(0.8f, 0.43f, knob.angle_min, knob.angle, detail::GetPrimaryColorSet());
-                }
-                break;
-            }
-            case ImGuiKnobVariant_WiperOnly: {
-                knob.draw_arc(0.8f, 0.41f, knob.angle_min, knob.angle_max, detail::GetTrackColorSet());
+                angle_max,
+                detail::skin_drawer{skin, steps});
+    }
 
-                if (knob.t > 0.01) {
-                    knob.draw_arc(0.8f, 0.43f, knob.angle_min, knob.angle, detail::GetPrimaryColorSet());
-                }
-                break;
-            }
-            case ImGuiKnobVariant_WiperDot: {
-                knob.draw_circle(0.6f, detail::GetSecondaryColorSet(), true, 32);
-                knob.draw_arc(0.85f, 0.41f, knob.angle_min, knob.angle_max, detail::GetTrackColorSet());
-                knob.draw_dot(0.1f, 0.85f, knob.angle, detail::GetPrimaryColorSet(), true, 12);
-                break;
-            }
-            case ImGuiKnobVariant_Stepped: {
-                for (auto n = 0.f; n < steps; n++) {
-                    auto a = n / (steps - 1);
-                    auto angle = knob.angle_min + (knob.angle_max - knob.angle_min) * a;
-                    knob.draw_tick(0.7f, 0.9f, 0.04f, angle, detail::GetPrimaryColorSet());
-                }
+    bool KnobFilmstrip(
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            const Filmstrip &filmstrip,
+            float speed,
+            const char *format,
+            float size,
+            ImGuiKnobFlags flags) {
+        return BaseKnob(
+                KnobHandle(label),
+                label,
+                ImGuiDataType_Float,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                0,
+                size,
+                flags,
+                -1,
+                -1,
+                detail::filmstrip_drawer{filmstrip});
+    }
 
-                knob.draw_circle(0.6f, detail::GetSecondaryColorSet(), true, 32);
-                knob.draw_dot(0.12f, 0.4f, knob.angle, detail::GetPrimaryColorSet(), true, 12);
-                break;
-            }
-            case ImGuiKnobVariant_Space: {
-                knob.draw_circle(0.3f - knob.t * 0.1f, detail::GetSecondaryColorSet(), true, 16);
+    bool KnobFilmstripInt(
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            const Filmstrip &filmstrip,
+            float speed,
+            const char *format,
+            float size,
+            ImGuiKnobFlags flags) {
+        return BaseKnob(
+                KnobHandle(label),
+                label,
+                ImGuiDataType_S32,
+                p_value,
+                v_min,
+                v_max,
+                speed,
+                format,
+                0,
+                size,
+                flags,
+                -1,
+                -1,
+                detail::filmstrip_drawer{filmstrip});
+    }
 
-                if (knob.t > 0.01f) {
-                    knob.draw_arc(0.4f, 0.15f, knob.angle_min - 1.0f, knob.angle - 1.0f, detail::GetPrimaryColorSet());
-                    knob.draw_arc(0.6f, 0.15f, knob.angle_min + 1.0f, knob.angle + 1.0f, detail::GetPrimaryColorSet());
-                    knob.draw_arc(0.8f, 0.15f, knob.angle_min + 3.0f, knob.angle + 3.0f, detail::GetPrimaryColorSet());
-                }
-                break;
-            }
+    template<typename DataType>
+    bool BaseKnobAtomic(
+            const char *label,
+            ImGuiDataType data_type,
+            std::atomic<DataType> *p_value,
+            DataType v_min,
+            DataType v_max,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max) {
+        // The knob works on a local copy. Other threads only observe values the user actually set.
+        auto value = p_value->load(std::memory_order_relaxed);
+        auto changed = BaseKnob(KnobHandle(label), label, data_type, &value, v_min, v_max, speed, format, variant, size, flags, angle_min, angle_max, detail::variant_drawer{variant, steps});
+        if (changed) {
+            p_value->store(value, std::memory_order_release);
         }
-
-        return knob.value_changed;
+        return changed;
     }
 
-    bool Knob(
+    bool KnobAtomic(
             const char *label,
-            float *p_value,
+            std::atomic<float> *p_value,
             float v_min,
             float v_max,
             float speed,
@@ -353,7 +2992,7 @@ namespace ImGuiKnobs {
             int steps,
             float angle_min,
             float angle_max) {
-        return BaseKnob(
+        return BaseKnobAtomic(
                 label,
                 ImGuiDataType_Float,
                 p_value,
@@ -369,9 +3008,9 @@ namespace ImGuiKnobs {
                 angle_max);
     }
 
-    bool KnobInt(
+    bool KnobAtomic(
             const char *label,
-            int *p_value,
+            std::atomic<int> *p_value,
             int v_min,
             int v_max,
             float speed,
@@ -382,7 +3021,7 @@ namespace ImGuiKnobs {
             int steps,
             float angle_min,
             float angle_max) {
-        return BaseKnob(
+        return BaseKnobAtomic(
                 label,
                 ImGuiDataType_S32,
                 p_value,
@@ -397,4 +3036,401 @@ namespace ImGuiKnobs {
                 angle_min,
                 angle_max);
     }
+
+    template<typename DataType>
+    int BaseKnobBank(
+            const char *str_id,
+            ImGuiDataType data_type,
+            DataType *values,
+            const DataType *mins,
+            const DataType *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        detail::bank<DataType> bank(str_id, data_type, values, mins, maxes, labels, speed, format, variant, size, flags, steps, angle_min, angle_max, changed);
+        columns = ImMax(columns, 1);
+
+        for (int i = 0; i < count; i++) {
+            if (i % columns != 0) {
+                ImGui::SameLine();
+            }
+            bank.draw(i);
+        }
+
+        return bank.end();
+    }
+
+    template<typename DataType>
+    int BaseKnobGrid(
+            const char *str_id,
+            ImGuiDataType data_type,
+            DataType *values,
+            const DataType *mins,
+            const DataType *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        detail::bank<DataType> bank(str_id, data_type, values, mins, maxes, labels, speed, format, variant, size, flags, steps, angle_min, angle_max, changed);
+        columns = ImMax(columns, 1);
+        auto rows = (count + columns - 1) / columns;
+
+        // The knob being dragged must be submitted every frame, or ImGui drops its active ID once it is
+        // scrolled out of view. Its index is kept in the window storage, under an ID of the grid scope.
+        auto *storage = ImGui::GetStateStorage();
+        auto active_key = ImGui::GetID("##active");
+        auto previous_active = storage->GetInt(active_key, -1);
+        auto active = -1;
+
+        ImGuiListClipper clipper;
+        clipper.Begin(rows);
+        if (previous_active >= 0 && previous_active < count) {
+            // The clipper learned to keep rows submitted in 1.86, and the function was renamed twice since
+            auto active_row = previous_active / columns;
+#if IMGUI_VERSION_NUM >= 18990
+            clipper.IncludeItemByIndex(active_row);
+#elif IMGUI_VERSION_NUM >= 18960
+            clipper.IncludeRangeByIndices(active_row, active_row + 1);
+#elif IMGUI_VERSION_NUM >= 18600
+            clipper.ForceDisplayRangeByIndices(active_row, active_row + 1);
+#else
+            IM_UNUSED(active_row);
+#endif
+        }
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                auto end = ImMin((row + 1) * columns, count);
+                for (int i = row * columns; i < end; i++) {
+                    if (i != row * columns) {
+                        ImGui::SameLine();
+                    }
+                    if (bank.draw(i)) {
+                        active = i;
+                    }
+                }
+            }
+        }
+        clipper.End();
+
+        storage->SetInt(active_key, active);
+
+        return bank.end();
+    }
+
+    int KnobBank(
+            const char *str_id,
+            float *values,
+            const float *mins,
+            const float *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        return BaseKnobBank(
+                str_id,
+                ImGuiDataType_Float,
+                values,
+                mins,
+                maxes,
+                labels,
+                count,
+                columns,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                steps,
+                angle_min,
+                angle_max,
+                changed);
+    }
+
+    int KnobBankInt(
+            const char *str_id,
+            int *values,
+            const int *mins,
+            const int *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        return BaseKnobBank(
+                str_id,
+                ImGuiDataType_S32,
+                values,
+                mins,
+                maxes,
+                labels,
+                count,
+                columns,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                steps,
+                angle_min,
+                angle_max,
+                changed);
+    }
+
+    int KnobGrid(
+            const char *str_id,
+            float *values,
+            const float *mins,
+            const float *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        return BaseKnobGrid(
+                str_id,
+                ImGuiDataType_Float,
+                values,
+                mins,
+                maxes,
+                labels,
+                count,
+                columns,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                steps,
+                angle_min,
+                angle_max,
+                changed);
+    }
+
+    int KnobGridInt(
+            const char *str_id,
+            int *values,
+            const int *mins,
+            const int *maxes,
+            const char *const *labels,
+            int count,
+            int columns,
+            float speed,
+            const char *format,
+            ImGuiKnobVariant variant,
+            float size,
+            ImGuiKnobFlags flags,
+            int steps,
+            float angle_min,
+            float angle_max,
+            int *changed) {
+        return BaseKnobGrid(
+                str_id,
+                ImGuiDataType_S32,
+                values,
+                mins,
+                maxes,
+                labels,
+                count,
+                columns,
+                speed,
+                format,
+                variant,
+                size,
+                flags,
+                steps,
+                angle_min,
+                angle_max,
+                changed);
+    }
+
+    IM_STATIC_ASSERT((IMGUIKNOBS_EVENT_QUEUE_CAPACITY & (IMGUIKNOBS_EVENT_QUEUE_CAPACITY - 1)) == 0);
+
+    bool EventQueue::Push(const Event &event) {
+        auto write = write_index.load(std::memory_order_relaxed);
+        if (write - read_index.load(std::memory_order_acquire) == IMGUIKNOBS_EVENT_QUEUE_CAPACITY) {
+            return false;
+        }
+        events[write & (IMGUIKNOBS_EVENT_QUEUE_CAPACITY - 1)] = event;
+        write_index.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool EventQueue::Pop(Event *event) {
+        auto read = read_index.load(std::memory_order_relaxed);
+        if (read == write_index.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *event = events[read & (IMGUIKNOBS_EVENT_QUEUE_CAPACITY - 1)];
+        read_index.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+    void SetEventQueue(EventQueue *queue) {
+        detail::event_queue = queue;
+        detail::pending_events.clear();
+    }
+
+    void SetNextKnobParam(ImGuiID param_id) {
+        detail::has_next_param = true;
+        detail::next_param_id = param_id;
+    }
+
+    ModulationBuffer::ModulationBuffer(int count) : Count(count), state(1 | state_fresh), write_buffer(0), read_buffer(2) {
+        for (auto &buffer: buffers) {
+            buffer = (float *) IM_ALLOC(sizeof(float) * count);
+            memset(buffer, 0, sizeof(float) * count);
+        }
+    }
+
+    ModulationBuffer::~ModulationBuffer() {
+        for (auto &buffer: buffers) {
+            IM_FREE(buffer);
+        }
+    }
+
+    float *ModulationBuffer::BeginWrite() {
+        return buffers[write_buffer];
+    }
+
+    void ModulationBuffer::EndWrite() {
+        // Hand the written buffer over and take back the one the reader is not using
+        write_buffer = state.exchange(write_buffer | state_fresh, std::memory_order_acq_rel) & ~state_fresh;
+    }
+
+    const float *ModulationBuffer::Read() {
+        if (state.load(std::memory_order_relaxed) & state_fresh) {
+            read_buffer = state.exchange(read_buffer, std::memory_order_acq_rel) & ~state_fresh;
+        }
+        return buffers[read_buffer];
+    }
+
+    void SetNextKnobModulation(float value) {
+        detail::has_next_modulation = true;
+        detail::next_modulation = value;
+    }
+
+    void SetNextKnobBankModulation(const float *values) {
+        detail::next_bank_modulation = values;
+    }
+
+    bool NeedsRedraw() {
+        const auto &redraw = detail::redraw;
+        if (redraw.frame != ImGui::GetFrameCount()) {
+            // No knob was drawn this frame: only a knob that was hovered before has anything left to update
+            return redraw.frame == ImGui::GetFrameCount() - 1 && redraw.hovered != 0;
+        }
+        return redraw.needs_redraw || redraw.hovered != redraw.previous_hovered;
+    }
+
+    int FormatValue(char *buf, int buf_size, ImGuiDataType data_type, const void *p_data, const char *format) {
+        const auto &spec = detail::compiled_format(format);
+        auto length = spec.kind == detail::format_kind_printf ? -1 : detail::format_spec_value(buf, buf_size, spec, data_type, p_data);
+        if (length < 0) {
+            length = ImGui::DataTypeFormatString(buf, buf_size, data_type, p_data, format);
+        }
+        return length;
+    }
+
+    void BakeKnobBackground(ImFontAtlas *atlas, ImGuiKnobVariant variant, float width, int steps, float angle_min, float angle_max) {
+        Skin layers;
+        switch (variant) {
+            case ImGuiKnobVariant_Tick:
+                detail::recipe<ImGuiKnobVariant_Tick>::static_layers(layers);
+                break;
+            case ImGuiKnobVariant_Dot:
+                detail::recipe<ImGuiKnobVariant_Dot>::static_layers(layers);
+                break;
+            case ImGuiKnobVariant_Wiper:
+                detail::recipe<ImGuiKnobVariant_Wiper>::static_layers(layers);
+                break;
+            case ImGuiKnobVariant_WiperOnly:
+                detail::recipe<ImGuiKnobVariant_WiperOnly>::static_layers(layers);
+                break;
+            case ImGuiKnobVariant_WiperDot:
+                detail::recipe<ImGuiKnobVariant_WiperDot>::static_layers(layers);
+                break;
+            case ImGuiKnobVariant_Stepped:
+                detail::recipe<ImGuiKnobVariant_Stepped>::static_layers(layers);
+                break;
+        }
+
+        detail::mesh_key key;
+        memset(&key, 0, sizeof(key));
+        if (layers.StaticCount > 0 && detail::background_key(key, variant, steps, detail::resolve_angle_min(angle_min), detail::resolve_angle_max(angle_max))) {
+            detail::bake_background(atlas, key, layers, width);
+        }
+    }
+
+    void BakeKnobBackground(ImFontAtlas *atlas, const Skin &skin, float width, int steps, float angle_min, float angle_max) {
+        detail::mesh_key key;
+        memset(&key, 0, sizeof(key));
+        if (detail::skin_background_key(key, skin, steps, detail::resolve_angle_min(angle_min), detail::resolve_angle_max(angle_max))) {
+            detail::bake_background(atlas, key, skin, width);
+        }
+    }
+
+    void RenderKnobBackgrounds(ImFontAtlas *atlas) {
+#if IMGUI_VERSION_NUM < 19197
+        IM_ASSERT((atlas->TexPixelsAlpha8 || atlas->TexPixelsRGBA32) && "Build the atlas first");
+        auto &pool = detail::baked_backgrounds;
+        for (int n = 0; n < pool.GetMapSize(); n++) {
+            auto *baked = pool.TryGetMapData(n);
+            if (baked && baked->atlas == atlas) {
+                detail::render_baked_background(*baked);
+            }
+        }
+#else
+        IM_UNUSED(atlas);
+#endif
+    }
+
+    Config &GetConfig() {
+        static Config config;
+        return config;
+    }
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+    const Stats &GetStats() {
+        return detail::stats;
+    }
+#endif
 }// namespace ImGuiKnobs
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdlib>
 #include <imgui.h>
 
@@ -27,6 +28,43 @@ enum ImGuiKnobVariant_ {
     ImGuiKnobVariant_Space = 1 << 6,
 };
 
+typedef int ImGuiKnobEventFlags;
+
+enum ImGuiKnobEventFlags_ {
+    ImGuiKnobEventFlags_GestureBegin = 1 << 0,// The user started dragging the knob or editing its input
+    ImGuiKnobEventFlags_ValueChanged = 1 << 1,
+    ImGuiKnobEventFlags_GestureEnd = 1 << 2,// The user released the knob or its input
+    ImGuiKnobEventFlags_DefaultParam = 1 << 3,// param_id is the ImGui ID of the knob, no SetNextKnobParam() preceded it
+};
+
+typedef int ImGuiKnobSkinLayer;
+
+// Layers of a skin. Sizes are fractions of the knob radius.
+enum ImGuiKnobSkinLayer_ {
+    ImGuiKnobSkinLayer_Circle,    // Filled circle: a = radius
+    ImGuiKnobSkinLayer_Track,     // Arc over the whole range: a = radius, b = width
+    ImGuiKnobSkinLayer_Value,     // Arc from the minimum to the value: a = radius, b = width
+    ImGuiKnobSkinLayer_Modulation,// Arc from the value to the modulated value: a = radius, b = width
+    ImGuiKnobSkinLayer_Ticks,     // One tick per step: a = start, b = end, c = width
+    ImGuiKnobSkinLayer_Tick,      // Tick at the value: a = start, b = end, c = width
+    ImGuiKnobSkinLayer_Dot,       // Dot at the value: a = distance from the center, b = radius
+};
+
+typedef int ImGuiKnobSkinColor;
+
+enum ImGuiKnobSkinColor_ {
+    ImGuiKnobSkinColor_Primary,   // ImGuiCol_ButtonActive, ImGuiCol_ButtonHovered when hovered
+    ImGuiKnobSkinColor_Secondary, // Primary at half brightness
+    ImGuiKnobSkinColor_Track,     // ImGuiCol_Button
+    ImGuiKnobSkinColor_Modulation,// ImGuiCol_PlotHistogram
+    ImGuiKnobSkinColor_COUNT
+};
+
+// Number of events an EventQueue holds, must be a power of two
+#ifndef IMGUIKNOBS_EVENT_QUEUE_CAPACITY
+#define IMGUIKNOBS_EVENT_QUEUE_CAPACITY 1024
+#endif
+
 namespace ImGuiKnobs {
 
     struct color_set {
@@ -71,4 +109,395 @@ namespace ImGuiKnobs {
             float angle_min = -1,
             float angle_max = -1);
 
+    // IDs of a knob, computed once so that knobs drawn from a handle do not hash their label every frame. A
+    // handle made from a label identifies the same knob as passing that label to Knob/KnobInt in the same ID
+    // scope. A handle made from an ID is independent of the ID stack, e.g. ImGui::GetID() called once. The
+    // knob itself never uses the scope ID, so it does not collide with another widget of the same label.
+    struct KnobHandle {
+        ImGuiID scope_id; // ID scope of the knob and its value input, like ImGui::PushID(label)
+        ImGuiID button_id;// ID of the knob item, inside that scope
+        ImGuiID input_id; // ID of the value input, inside that scope
+
+        KnobHandle() : scope_id(0), button_id(0), input_id(0) {}
+        explicit KnobHandle(ImGuiID scope_id);
+        KnobHandle(ImGuiID scope_id, const char *label);// The knob item is `label` inside the scope
+        explicit KnobHandle(const char *label);         // Uses the current ID stack, like ImGui::GetID()
+    };
+
+    // Same as Knob/KnobInt, with the IDs taken from `handle`. `label` is only used as the title.
+    bool Knob(
+            const KnobHandle &handle,
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            float speed = 0,
+            const char *format = "%.3f",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+    bool KnobInt(
+            const KnobHandle &handle,
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            float speed = 0,
+            const char *format = "%i",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+
+    struct SkinCommand {
+        ImGuiKnobSkinLayer layer;
+        ImGuiKnobSkinColor color;
+        float a;
+        float b;
+        float c;
+    };
+
+    // The look of a knob as a list of layers, drawn in order, for knobs that none of the variants fit. Layers are
+    // stored as a flat array of commands. When GetConfig().mesh_cache is set, the leading layers that do not
+    // depend on the value (circle, track, ticks) are drawn from a single cached mesh.
+    struct Skin {
+        Skin() : StaticCount(0), ID(0) {}
+
+        // Appends a layer, see ImGuiKnobSkinLayer_ for the meaning of a, b and c
+        Skin &Add(ImGuiKnobSkinLayer layer, ImGuiKnobSkinColor color, float a, float b = 0, float c = 0);
+
+        // Replaces the layers with the ones described by `text`, separated by new lines or ';', e.g.
+        // "circle 0.7; track 0.8 0.41; value 0.8 0.43 primary". Each layer is its lowercase name, its sizes
+        // and optionally a color (primary, secondary, track or modulation). '#' starts a comment. Returns
+        // false and leaves the skin empty on a syntax error.
+        bool Parse(const char *text);
+
+        // Set by Add() and Parse()
+        ImVector<SkinCommand> Commands;
+        int StaticCount;// Number of leading commands that do not depend on the value
+        ImGuiID ID;     // Hash of the commands
+    };
+
+    // Same as Knob/KnobInt, drawn with `skin` instead of a variant. `steps` is the number of ticks of Ticks layers.
+    bool Knob(
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            const Skin &skin,
+            float speed = 0,
+            const char *format = "%.3f",
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+    bool KnobInt(
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            const Skin &skin,
+            float speed = 0,
+            const char *format = "%i",
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+
+    // Pre-rendered frames of a knob, from the minimum to the maximum value, laid out left to right then top to
+    // bottom in `Columns` columns between UVMin and UVMax of a texture. One column is a vertical strip.
+    struct Filmstrip {
+        Filmstrip() : TextureID(0), FrameCount(0), Columns(1), UVMin(0.0f, 0.0f), UVMax(1.0f, 1.0f) {}
+        Filmstrip(ImTextureID texture_id, int frame_count, int columns = 1, const ImVec2 &uv_min = ImVec2(0.0f, 0.0f), const ImVec2 &uv_max = ImVec2(1.0f, 1.0f))
+            : TextureID(texture_id), FrameCount(frame_count), Columns(columns), UVMin(uv_min), UVMax(uv_max) {}
+
+        ImTextureID TextureID;
+        int FrameCount;
+        int Columns;
+        ImVec2 UVMin;
+        ImVec2 UVMax;
+    };
+
+    // Same as Knob/KnobInt, drawn as the frame of `filmstrip` nearest to the value: a single textured quad
+    // however detailed the frames are. Modulation is not shown.
+    bool KnobFilmstrip(
+            const char *label,
+            float *p_value,
+            float v_min,
+            float v_max,
+            const Filmstrip &filmstrip,
+            float speed = 0,
+            const char *format = "%.3f",
+            float size = 0,
+            ImGuiKnobFlags flags = 0);
+    bool KnobFilmstripInt(
+            const char *label,
+            int *p_value,
+            int v_min,
+            int v_max,
+            const Filmstrip &filmstrip,
+            float speed = 0,
+            const char *format = "%i",
+            float size = 0,
+            ImGuiKnobFlags flags = 0);
+
+    // Same as Knob/KnobInt, bound to a value shared with another thread (e.g. an audio thread). The value is
+    // read with a relaxed load, and only stored (with release ordering) when the knob or its input changed it.
+    bool KnobAtomic(
+            const char *label,
+            std::atomic<float> *p_value,
+            float v_min,
+            float v_max,
+            float speed = 0,
+            const char *format = "%.3f",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+    bool KnobAtomic(
+            const char *label,
+            std::atomic<int> *p_value,
+            int v_min,
+            int v_max,
+            float speed = 0,
+            const char *format = "%i",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1);
+
+    // Draws `count` knobs sharing one variant and layout, `columns` knobs per row, from parallel arrays of
+    // values, ranges and labels. Knob IDs are derived from `str_id` and the index. Returns the number of
+    // knobs whose value changed; when `changed` is not NULL their indices are written to it, so it must
+    // have room for `count` entries.
+    int KnobBank(
+            const char *str_id,
+            float *values,
+            const float *mins,
+            const float *maxes,
+            const char *const *labels,
+            int count,
+            int columns = 8,
+            float speed = 0,
+            const char *format = "%.3f",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1,
+            int *changed = NULL);
+    int KnobBankInt(
+            const char *str_id,
+            int *values,
+            const int *mins,
+            const int *maxes,
+            const char *const *labels,
+            int count,
+            int columns = 8,
+            float speed = 0,
+            const char *format = "%i",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1,
+            int *changed = NULL);
+
+    // Same as KnobBank, but only the rows visible in the current window are submitted (using ImGuiListClipper),
+    // so the cost per frame depends on the window size rather than on `count`. The knob being dragged keeps
+    // being submitted while scrolled out of view, so the drag is not interrupted.
+    int KnobGrid(
+            const char *str_id,
+            float *values,
+            const float *mins,
+            const float *maxes,
+            const char *const *labels,
+            int count,
+            int columns = 8,
+            float speed = 0,
+            const char *format = "%.3f",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1,
+            int *changed = NULL);
+    int KnobGridInt(
+            const char *str_id,
+            int *values,
+            const int *mins,
+            const int *maxes,
+            const char *const *labels,
+            int count,
+            int columns = 8,
+            float speed = 0,
+            const char *format = "%i",
+            ImGuiKnobVariant variant = ImGuiKnobVariant_Tick,
+            float size = 0,
+            ImGuiKnobFlags flags = 0,
+            int steps = 10,
+            float angle_min = -1,
+            float angle_max = -1,
+            int *changed = NULL);
+
+    // A knob emits at most one event per frame. When several flags are set they happened in the order
+    // GestureBegin, ValueChanged, GestureEnd. Int values are converted to float.
+    struct Event {
+        ImGuiID param_id;
+        ImGuiKnobEventFlags flags;
+        float value;
+        double time;// ImGui::GetTime() of the frame
+    };
+
+    // Bounded lock-free queue with a single producer (the UI thread drawing the knobs) and a single consumer
+    // (e.g. the audio thread draining it once per block).
+    struct EventQueue {
+        EventQueue() : write_index(0), read_index(0) {}
+
+        // Returns false, dropping the event, when the queue is full
+        bool Push(const Event &event);
+        // Returns false when the queue is empty
+        bool Pop(Event *event);
+
+        Event events[IMGUIKNOBS_EVENT_QUEUE_CAPACITY];
+        alignas(64) std::atomic<unsigned int> write_index;
+        alignas(64) std::atomic<unsigned int> read_index;
+    };
+
+    // Knobs push their events to `queue` while it is set. Pass NULL to stop. Events that find the queue full are
+    // kept, merged per param_id, and pushed again by later knobs, so a gesture end is delivered late, not lost.
+    void SetEventQueue(EventQueue *queue);
+
+    // Sets the param_id of the events of the next Knob/KnobInt/KnobAtomic call. The knobs of the next
+    // KnobBank/KnobGrid call get `param_id + index`. Without it, param_id is the ImGui ID of the knob and the
+    // events carry ImGuiKnobEventFlags_DefaultParam.
+    void SetNextKnobParam(ImGuiID param_id);
+
+    // Triple buffer of modulated values, written by one thread (e.g. the audio thread once per block) and read by
+    // the UI thread. Neither side ever waits, and the reader always sees the latest complete set of values.
+    struct ModulationBuffer {
+        explicit ModulationBuffer(int count);
+        ~ModulationBuffer();
+
+        // Writer: fill all `Count` values of the returned buffer, then publish them with EndWrite()
+        float *BeginWrite();
+        void EndWrite();
+
+        // Reader: returns the latest published values
+        const float *Read();
+
+        int Count;
+
+    private:
+        enum { state_fresh = 4 };
+
+        float *buffers[3];
+        std::atomic<int> state;// Index of the buffer between writer and reader, | state_fresh when it was not read yet
+        int write_buffer;
+        int read_buffer;
+
+        ModulationBuffer(const ModulationBuffer &);
+        ModulationBuffer &operator=(const ModulationBuffer &);
+    };
+
+    // Shows `value`, e.g. the modulated value of the parameter, as a ring on the track of the next knob
+    // (Wiper, WiperOnly and WiperDot variants)
+    void SetNextKnobModulation(float value);
+
+    // Same for the next KnobBank/KnobGrid call, knob `i` shows `values[i]`. Only the values of visible knobs are
+    // read. The array must stay valid for the duration of that call.
+    void SetNextKnobBankModulation(const float *values);
+
+    // Returns true when the knobs drawn this frame need another frame even without new input: a knob or its
+    // input is active, a value changed, or the hovered knob changed. Hosts that only render on input events
+    // can call it after drawing the frame and keep rendering while it returns true.
+    bool NeedsRedraw();
+
+    // Formats a value like ImGui::DataTypeFormatString() (used by DragScalar) and returns the length. Float and
+    // int values with a "%f", "%.Nf" (N <= 7), "%d" or "%i" conversion, optionally between a literal prefix and
+    // suffix (e.g. "%.1fdB"), are formatted without printf; any other format falls back to it.
+    int FormatValue(char *buf, int buf_size, ImGuiDataType data_type, const void *p_data, const char *format);
+
+    // Bakes the parts of a variant that do not depend on the value into `atlas`, for knobs `width` pixels wide
+    // (the size argument times the font scale, or 4 line heights by default). Matching knobs then draw them as
+    // one textured quad per color instead of a mesh. Call before the atlas is built; the other arguments must
+    // match the Knob() calls. Knobs without a baked background use the mesh cache, as do all knobs with Dear
+    // ImGui 1.92 and later, whose reworked atlas API is not supported.
+    void BakeKnobBackground(ImFontAtlas *atlas, ImGuiKnobVariant variant, float width, int steps = 10, float angle_min = -1, float angle_max = -1);
+
+    // Same for the static layers of `skin`
+    void BakeKnobBackground(ImFontAtlas *atlas, const Skin &skin, float width, int steps = 10, float angle_min = -1, float angle_max = -1);
+
+    // Rasterizes the backgrounds baked into `atlas`. Call after every build of the atlas and before uploading its
+    // texture, e.g. after ImFontAtlas::GetTexDataAsRGBA32(). Backgrounds whose rectangles were removed by
+    // ImFontAtlas::Clear() are dropped until baked again.
+    void RenderKnobBackgrounds(ImFontAtlas *atlas);
+
+    struct Config {
+        // Draw circles and the parts of each variant that do not depend on the value (body, track, tick ring)
+        // from cached meshes tessellated once per size, instead of tessellating them every frame. The cache is
+        // shared by all contexts, cleared when it fills up and freed when a context is destroyed.
+        bool mesh_cache = true;
+
+        // Draw the backgrounds given to BakeKnobBackground() from the font atlas
+        bool baked_backgrounds = true;
+
+        // Level of detail. Segment counts of circles and arcs are chosen so the tessellation deviates at most
+        // `lod_max_error` pixels from the true curve (0 leaves them to ImGui, which draws from its table of
+        // precomputed circle points within ImGuiStyle::CircleTessellationMaxError). Knobs
+        // with a radius below `lod_no_aa_radius` pixels are drawn without anti-aliasing fringes, and knobs
+        // below `lod_simplify_radius` pixels draw a simplified variant (e.g. a single arc for Space).
+        float lod_max_error = 0.0f;
+        float lod_no_aa_radius = 0.0f;
+        float lod_simplify_radius = 0.0f;
+    };
+
+    Config &GetConfig();
+
+#ifdef IMGUIKNOBS_ENABLE_STATS
+    // Geometry statistics, only available when compiled with IMGUIKNOBS_ENABLE_STATS.
+    // Counters are reset on the first knob of every frame.
+    enum StatsPrimitive_ {
+        StatsPrimitive_Circle,
+        StatsPrimitive_Arc,
+        StatsPrimitive_Tick,
+        StatsPrimitive_Dot,
+        StatsPrimitive_COUNT
+    };
+
+    struct StatsCounters {
+        int calls;
+        int vertices;
+        int indices;
+        int path_points;
+    };
+
+    struct Stats {
+        static const int VariantCount = 7;
+
+        int frame;
+        int knobs[VariantCount];// Indexed by the bit position of the variant, see VariantIndex()
+        StatsCounters counters[VariantCount][StatsPrimitive_COUNT];
+
+        static int VariantIndex(ImGuiKnobVariant variant);
+        StatsCounters Total(ImGuiKnobVariant variant) const;
+        StatsCounters Total() const;
+    };
+
+    const Stats &GetStats();
+#endif
 }// namespace ImGuiKnobs